@@ -0,0 +1,446 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file bench/bench.c
+ * @brief Microbenchmarks for the tokenizer, parser and validators.
+ *
+ * Generates expression corpora across sizes and nesting depths, then reports ns/token,
+ * tokens/sec and heap allocations per run for each pipeline stage in isolation.
+ *
+ * Usage: ./build/bench [min-seconds-per-case]
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "lexer/token_list.h"
+#include "lexer/tokenizer.h"
+#include "parser.h"
+#include "bytecode.h"
+#include "batch.h"
+#include "cache.h"
+#include "parallel.h"
+#include "stats.h"
+#include "jit.h"
+
+#include "harness.h"
+
+// --- Corpus Generation ---
+
+typedef struct BenchBuffer {
+    char* data;
+    size_t length;
+    size_t capacity;
+} BenchBuffer;
+
+static void bench_append(BenchBuffer* buffer, const char* text) {
+    size_t size = strlen(text);
+    if (buffer->length + size + 1 > buffer->capacity) {
+        size_t capacity = (buffer->capacity + size + 1) * 2;
+        char* data = realloc(buffer->data, capacity);
+        if (!data) {
+            fprintf(stderr, "[BENCH] Out of memory while generating corpus.\n");
+            exit(EXIT_FAILURE);
+        }
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->length, text, size + 1);
+    buffer->length += size;
+}
+
+/// @brief Builds an expression with `operands` operands and parentheses nested up to `depth`.
+static char* bench_generate(size_t operands, size_t depth) {
+    static const char* operators[] = {" + ", " - ", " * ", " / ", " % "};
+    BenchBuffer buffer = {0};
+    size_t open = 0;
+    char literal[32];
+
+    for (size_t i = 0; i < operands; i++) {
+        while (open < depth && harness_rand() % 3 == 0) {
+            bench_append(&buffer, "(");
+            open++;
+        }
+
+        if (harness_rand() % 8 == 0) {
+            bench_append(&buffer, "-");
+        }
+
+        if (harness_rand() % 4 == 0) {
+            const uint32_t whole = harness_rand() % 1000;
+            snprintf(literal, sizeof(literal), "%u.%u", whole, harness_rand() % 100);
+        } else {
+            snprintf(literal, sizeof(literal), "%u", harness_rand() % 100000);
+        }
+        bench_append(&buffer, literal);
+
+        while (open > 0 && harness_rand() % 3 == 0) {
+            bench_append(&buffer, ")");
+            open--;
+        }
+
+        if (i + 1 < operands) {
+            bench_append(&buffer, operators[harness_rand() % 5]);
+        }
+    }
+
+    while (open-- > 0) {
+        bench_append(&buffer, ")");
+    }
+
+    return buffer.data;
+}
+
+// --- Stages ---
+
+typedef enum BenchStage {
+    BENCH_TOKENIZER,
+    BENCH_SHUNT_YARD,
+    BENCH_VALID_INFIX,
+    BENCH_VALID_POSTFIX,
+    BENCH_SHUNT_VALIDATED,
+    BENCH_SHUNT_EXPRESSION,
+    BENCH_SHUNT_CONTEXT,
+    BENCH_SHUNT_CACHE,
+    BENCH_COMPILE,
+    BENCH_STAGE_COUNT,
+} BenchStage;
+
+static const char* bench_stage_names[BENCH_STAGE_COUNT] = {
+    "tokenizer",
+    "shunt_yard",
+    "shunt_is_valid_infix",
+    "shunt_is_valid_postfix",
+    "shunt_yard_validated",
+    "shunt_expression",
+    "shunt_context_parse",
+    "shunt_cache_acquire",
+    "bytecode_compile",
+};
+
+typedef struct BenchCase {
+    const char* expression;
+    size_t length;
+    TokenList* infix; // Prebuilt input for the stages that need it
+    TokenList* postfix;
+    ShuntContext* context;
+    ShuntCache* cache; // Warmed by the first run, so the stage measures hits
+} BenchCase;
+
+static void bench_run_once(BenchCase* bench, BenchStage stage) {
+    switch (stage) {
+        case BENCH_TOKENIZER: {
+            TokenList* list = tokenizer(bench->expression);
+            harness_sink += list ? list->count : 0;
+            token_list_free(list);
+            break;
+        }
+        case BENCH_SHUNT_YARD: {
+            TokenList* list = shunt_yard(bench->infix);
+            harness_sink += list ? list->count : 0;
+            token_list_free(list);
+            break;
+        }
+        case BENCH_VALID_INFIX:
+            harness_sink += shunt_is_valid_infix(bench->infix);
+            break;
+        case BENCH_VALID_POSTFIX:
+            harness_sink += shunt_is_valid_postfix(bench->postfix);
+            break;
+        case BENCH_SHUNT_VALIDATED: {
+            size_t depth = 0;
+            TokenList* list = shunt_yard_validated(bench->infix, NULL, &depth, NULL);
+            harness_sink += list ? list->count + depth : 0;
+            token_list_free(list);
+            break;
+        }
+        case BENCH_SHUNT_EXPRESSION: {
+            TokenList* list = shunt_expression(bench->expression, bench->length, NULL);
+            harness_sink += list ? list->count : 0;
+            token_list_free(list);
+            break;
+        }
+        case BENCH_SHUNT_CONTEXT: {
+            const TokenList* list
+                = shunt_context_parse(bench->context, bench->expression, bench->length);
+            harness_sink += list ? list->count : 0;
+            break;
+        }
+        case BENCH_SHUNT_CACHE: {
+            const ShuntCacheEntry* entry
+                = shunt_cache_acquire(bench->cache, bench->expression, bench->length, NULL);
+            harness_sink += entry ? entry->program->count : 0;
+            shunt_cache_release(bench->cache, entry);
+            break;
+        }
+        case BENCH_COMPILE: {
+            Bytecode* program = bytecode_compile(bench->postfix);
+            harness_sink += program ? program->count : 0;
+            bytecode_free(program);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void bench_measure(BenchCase* bench, BenchStage stage, size_t depth, double seconds) {
+    bench_run_once(bench, stage); // warm caches and the context high-water mark
+
+    size_t runs = 0;
+    size_t allocs = harness_alloc_count();
+    double start = harness_now();
+    double elapsed = 0.0;
+    do {
+        bench_run_once(bench, stage);
+        runs++;
+        elapsed = harness_now() - start;
+    } while (elapsed < seconds);
+    allocs = harness_alloc_count() - allocs;
+
+    const size_t tokens = bench->infix->count;
+    const double ns_per_token = elapsed * 1e9 / ((double) runs * (double) tokens);
+
+    printf(
+        "[BENCH] stage=%-22s tokens=%-7zu depth=%-3zu ns/token=%-8.2f tokens/s=%-12.0f",
+        bench_stage_names[stage],
+        tokens,
+        depth,
+        ns_per_token,
+        1e9 / ns_per_token
+    );
+    if (HARNESS_TRACKS_HEAP) {
+        printf(" allocs/run=%.1f\n", (double) allocs / (double) runs);
+    } else {
+        printf(" allocs/run=n/a\n");
+    }
+}
+
+// --- Batch Scaling ---
+
+#define BENCH_BATCH_EXPRESSIONS 65536
+#define BENCH_BATCH_OPERANDS 16
+
+/// @brief Converts a set of independent expressions with 1, 2, 4, ... workers up to the core count.
+static void bench_batch(double seconds) {
+    char** expressions = malloc(sizeof(char*) * BENCH_BATCH_EXPRESSIONS);
+    if (!expressions) {
+        fprintf(stderr, "[BENCH] Out of memory while generating batch corpus.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < BENCH_BATCH_EXPRESSIONS; i++) {
+        expressions[i] = bench_generate(BENCH_BATCH_OPERANDS, 4);
+    }
+
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t cores = online > 0 ? (size_t) online : 1;
+    for (size_t threads = 1;; threads *= 2) {
+        if (threads > cores) {
+            threads = cores;
+        }
+
+        size_t runs = 0;
+        double start = harness_now();
+        double elapsed = 0.0;
+        do {
+            ShuntBatch* batch = shunt_batch(
+                (const char* const*) expressions, NULL, BENCH_BATCH_EXPRESSIONS, threads
+            );
+            harness_sink += batch ? batch->failures : 0;
+            shunt_batch_free(batch);
+            runs++;
+            elapsed = harness_now() - start;
+        } while (elapsed < seconds);
+
+        printf(
+            "[BENCH] stage=%-22s expressions=%-7d threads=%-3zu ns/expr=%-8.2f expr/s=%.0f\n",
+            "shunt_batch",
+            BENCH_BATCH_EXPRESSIONS,
+            threads,
+            elapsed * 1e9 / ((double) runs * BENCH_BATCH_EXPRESSIONS),
+            (double) runs * BENCH_BATCH_EXPRESSIONS / elapsed
+        );
+
+        if (threads == cores) {
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < BENCH_BATCH_EXPRESSIONS; i++) {
+        free(expressions[i]);
+    }
+    free(expressions);
+}
+
+// --- Parallel Scaling ---
+
+#define BENCH_PARALLEL_GROUPS 256
+#define BENCH_PARALLEL_OPERANDS 8192
+
+/// @brief Converts one large expression (a sum of parenthesized groups, as generated formulas
+///        tend to be) with 1, 2, 4, ... workers up to the core count.
+static void bench_parallel(double seconds) {
+    BenchBuffer buffer = {0};
+    for (size_t i = 0; i < BENCH_PARALLEL_GROUPS; i++) {
+        char* group = bench_generate(BENCH_PARALLEL_OPERANDS, 8);
+        bench_append(&buffer, i > 0 ? " + (" : "(");
+        bench_append(&buffer, group);
+        bench_append(&buffer, ")");
+        free(group);
+    }
+
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t cores = online > 0 ? (size_t) online : 1;
+    for (size_t threads = 1;; threads *= 2) {
+        if (threads > cores) {
+            threads = cores;
+        }
+
+        size_t runs = 0;
+        size_t tokens = 0;
+        double start = harness_now();
+        double elapsed = 0.0;
+        do {
+            TokenArray* postfix
+                = shunt_parallel_expression(buffer.data, buffer.length, threads, NULL);
+            tokens = postfix ? postfix->count : 0;
+            harness_sink += tokens;
+            token_array_free(postfix);
+            runs++;
+            elapsed = harness_now() - start;
+        } while (elapsed < seconds);
+
+        printf(
+            "[BENCH] stage=%-22s bytes=%-9zu threads=%-3zu ns/byte=%-8.2f MB/s=%.1f\n",
+            "shunt_parallel",
+            buffer.length,
+            threads,
+            elapsed * 1e9 / ((double) runs * (double) buffer.length),
+            (double) runs * (double) buffer.length / elapsed * 1e-6
+        );
+
+        if (threads == cores) {
+            break;
+        }
+    }
+
+    free(buffer.data);
+}
+
+// --- Native Execution ---
+
+#define BENCH_JIT_VARIABLES 8
+
+/// @brief Runs a float program over variables (constant corpora fold away) interpreted and native.
+static void bench_jit(double seconds) {
+    const char* expression = "(a * b + c / 2.5 - d) * (e - f * 0.5) / (g + h * 1.5 + 3.0)";
+    TokenList* postfix = shunt_expression(expression, strlen(expression), NULL);
+    Bytecode* program = postfix ? bytecode_compile(postfix) : NULL;
+    token_list_free(postfix);
+    if (!program || program->variable_count != BENCH_JIT_VARIABLES) {
+        fprintf(stderr, "[BENCH] Failed to compile the native execution program.\n");
+        exit(EXIT_FAILURE);
+    }
+    program->jit_threshold = 0; // the interpreted pass must stay interpreted
+
+    double variables[BENCH_JIT_VARIABLES];
+    for (size_t i = 0; i < BENCH_JIT_VARIABLES; i++) {
+        variables[i] = 1.0 + (double) i * 0.25;
+    }
+
+    BytecodeJit* jit = bytecode_jit_compile(program);
+    for (size_t native = 0; native < (jit ? 2u : 1u); native++) {
+        size_t runs = 0;
+        double sum = 0.0;
+        double start = harness_now();
+        double elapsed = 0.0;
+        do {
+            for (size_t i = 0; i < 4096; i++) {
+                variables[0] = (double) (i & 63);
+                if (native) {
+                    sum += jit->function(variables);
+                } else {
+                    RpnValue value;
+                    bytecode_execute(program, variables, &value);
+                    sum += value.real;
+                }
+            }
+            runs += 4096;
+            elapsed = harness_now() - start;
+        } while (elapsed < seconds);
+        harness_sink += (size_t) sum;
+
+        printf(
+            "[BENCH] stage=%-22s instructions=%-6zu ns/run=%-8.2f runs/s=%.0f\n",
+            native ? "bytecode_native" : "bytecode_interpret",
+            program->count,
+            elapsed * 1e9 / (double) runs,
+            (double) runs / elapsed
+        );
+    }
+
+    bytecode_jit_free(jit);
+    bytecode_free(program);
+}
+
+// --- Main ---
+
+int main(int argc, char* argv[]) {
+    double seconds = argc > 1 ? strtod(argv[1], NULL) : 0.2;
+    if (seconds <= 0.0) {
+        seconds = 0.2;
+    }
+
+    const size_t sizes[] = {8, 64, 512, 4096, 32768};
+    const size_t depths[] = {0, 4, 32};
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(*sizes); s++) {
+        for (size_t d = 0; d < sizeof(depths) / sizeof(*depths); d++) {
+            char* expression = bench_generate(sizes[s], depths[d]);
+            BenchCase bench = {
+                .expression = expression,
+                .length = strlen(expression),
+                .infix = tokenizer(expression),
+                .context = shunt_context_create(),
+                .cache = shunt_cache_create(0),
+            };
+            bench.postfix = bench.infix ? shunt_yard(bench.infix) : NULL;
+
+            if (!bench.infix || !bench.postfix || !bench.context || !bench.cache) {
+                fprintf(stderr, "[BENCH] Failed to prepare corpus (size=%zu).\n", sizes[s]);
+                return EXIT_FAILURE;
+            }
+
+            for (size_t stage = 0; stage < BENCH_STAGE_COUNT; stage++) {
+                bench_measure(&bench, (BenchStage) stage, depths[d], seconds);
+            }
+
+            shunt_cache_free(bench.cache);
+            shunt_context_free(bench.context);
+            token_list_free(bench.postfix);
+            token_list_free(bench.infix);
+            free(expression);
+        }
+    }
+
+    bench_batch(seconds);
+    bench_parallel(seconds);
+    bench_jit(seconds);
+
+    // Library counters over the whole run (only when built with SHUNT_ENABLE_STATS)
+    ShuntStats stats;
+    if (shunt_stats_snapshot(&stats)) {
+        for (size_t i = 0; i < SHUNT_STAT_COUNT; i++) {
+            printf(
+                "[STATS] %s=%llu\n",
+                shunt_stat_to_string((ShuntStat) i),
+                (unsigned long long) stats.values[i]
+            );
+        }
+    }
+    return EXIT_SUCCESS;
+}
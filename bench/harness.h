@@ -0,0 +1,145 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file bench/harness.h
+ * @brief Allocation hooks, corpus RNG and clock shared by the bench and stress executables.
+ * @note Defines malloc/calloc/realloc/free overrides, so include it from exactly one translation
+ *       unit per executable. The hooks are built only on glibc without a sanitizer; otherwise
+ *       HARNESS_TRACKS_HEAP is 0 and the counters stay at zero.
+ * @note The hooks always count calls. Define HARNESS_MEASURE_PEAK before including to also track
+ *       live and peak bytes, which puts a malloc_usable_size() and two atomics on every call.
+ */
+
+#ifndef SHUNT_BENCH_HARNESS_H
+#define SHUNT_BENCH_HARNESS_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+// --- Heap Tracking ---
+
+// Relaxed: the batch and parallel stages allocate from several threads, only the totals matter
+static _Atomic size_t harness_allocs = 0; // Allocation calls so far
+static _Atomic size_t harness_live = 0; // Bytes currently allocated
+static _Atomic size_t harness_peak = 0; // High-water mark since harness_peak_reset()
+
+// Sanitizers interpose the allocator themselves; forwarding to glibc behind their back aborts
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+    #define HARNESS_SANITIZED 1
+#elif defined(__has_feature)
+    #if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer)
+        #define HARNESS_SANITIZED 1
+    #endif
+#endif
+
+#if defined(__GLIBC__) && !defined(HARNESS_SANITIZED)
+    #include <malloc.h>
+
+// glibc routes its own internal allocations (e.g. strndup) through these symbols as well
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+    #if defined(HARNESS_MEASURE_PEAK)
+static void harness_track(void* ptr) {
+    if (ptr) {
+        const size_t size = malloc_usable_size(ptr);
+        const size_t live
+            = atomic_fetch_add_explicit(&harness_live, size, memory_order_relaxed) + size;
+        size_t peak = atomic_load_explicit(&harness_peak, memory_order_relaxed);
+        while (live > peak
+               && !atomic_compare_exchange_weak_explicit(
+                   &harness_peak, &peak, live, memory_order_relaxed, memory_order_relaxed
+               )) {
+        }
+    }
+}
+
+static void harness_untrack(size_t size) {
+    atomic_fetch_sub_explicit(&harness_live, size, memory_order_relaxed);
+}
+
+        #define HARNESS_USABLE_SIZE(ptr) ((ptr) ? malloc_usable_size(ptr) : 0)
+    #else
+        // Counting calls only: byte tracking costs more than the allocations bench times
+        #define harness_track(ptr) ((void) (ptr))
+        #define harness_untrack(size) ((void) (size))
+        #define HARNESS_USABLE_SIZE(ptr) ((void) (ptr), (size_t) 0)
+    #endif
+
+void* malloc(size_t size) {
+    atomic_fetch_add_explicit(&harness_allocs, 1, memory_order_relaxed);
+    void* ptr = __libc_malloc(size);
+    harness_track(ptr);
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size) {
+    atomic_fetch_add_explicit(&harness_allocs, 1, memory_order_relaxed);
+    void* ptr = __libc_calloc(count, size);
+    harness_track(ptr);
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+    atomic_fetch_add_explicit(&harness_allocs, 1, memory_order_relaxed);
+    const size_t before = HARNESS_USABLE_SIZE(ptr);
+    void* moved = __libc_realloc(ptr, size);
+    if (moved || size == 0) {
+        harness_untrack(before); // the old block is gone either way
+        harness_track(moved);
+    }
+    return moved;
+}
+
+void free(void* ptr) {
+    harness_untrack(HARNESS_USABLE_SIZE(ptr));
+    __libc_free(ptr);
+}
+
+    #define HARNESS_TRACKS_HEAP 1
+#else
+    #define HARNESS_TRACKS_HEAP 0
+#endif
+
+static inline size_t harness_alloc_count(void) {
+    return atomic_load_explicit(&harness_allocs, memory_order_relaxed);
+}
+
+/// @return The live byte count the next harness_peak_bytes() reading is relative to.
+static inline size_t harness_peak_reset(void) {
+    const size_t live = atomic_load_explicit(&harness_live, memory_order_relaxed);
+    atomic_store_explicit(&harness_peak, live, memory_order_relaxed);
+    return live;
+}
+
+static inline size_t harness_peak_bytes(void) {
+    return atomic_load_explicit(&harness_peak, memory_order_relaxed);
+}
+
+// --- Random Input ---
+
+static uint64_t harness_seed = 0x9E3779B97F4A7C15ull;
+
+static inline uint32_t harness_rand(void) {
+    // xorshift64*: deterministic across runs so numbers stay comparable
+    harness_seed ^= harness_seed >> 12;
+    harness_seed ^= harness_seed << 25;
+    harness_seed ^= harness_seed >> 27;
+    return (uint32_t) ((harness_seed * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+// --- Timing ---
+
+static volatile size_t harness_sink = 0; // Keeps results observable to the optimizer
+
+static inline double harness_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+#endif // SHUNT_BENCH_HARNESS_H
@@ -0,0 +1,438 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file bench/stress.c
+ * @brief Worst-case latency and memory of the parse pipeline on adversarial and fuzzed input.
+ *
+ * Generates shapes that load the operator stack (deep nesting, long unary chains, right-to-left
+ * power chains, huge flat sums) plus random valid and random invalid input, then reports
+ * p50/p99/max parse time and peak heap per input size. A log-log fit of time and peak heap
+ * against size must stay near slope 1, or the run fails. Malformed input is rejected part way, so
+ * its rows report the tokens actually consumed and it is left out of the fit.
+ *
+ * Usage: ./build/stress [min-seconds-per-case]
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "lexer/token_list.h"
+#include "lexer/tokenizer.h"
+#include "parser.h"
+
+#define HARNESS_MEASURE_PEAK
+#include "harness.h"
+
+// --- Input Shapes ---
+
+typedef struct StressBuffer {
+    char* data;
+    size_t length;
+    size_t capacity;
+    size_t tokens; // Tokens written so far
+} StressBuffer;
+
+static void stress_append(StressBuffer* buffer, const char* text) {
+    size_t size = strlen(text);
+    if (buffer->length + size + 1 > buffer->capacity) {
+        size_t capacity = (buffer->capacity + size + 1) * 2;
+        char* data = realloc(buffer->data, capacity);
+        if (!data) {
+            fprintf(stderr, "[STRESS] Out of memory while generating input.\n");
+            exit(EXIT_FAILURE);
+        }
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->length, text, size + 1);
+    buffer->length += size;
+}
+
+/// @brief Appends one token (plus trailing spacing, if any).
+static void stress_token(StressBuffer* buffer, const char* text) {
+    stress_append(buffer, text);
+    buffer->tokens++;
+}
+
+/// @brief 1 + 1 + 1 ...: the output list grows while the operator stack never exceeds one.
+static void stress_flat_sum(StressBuffer* buffer, size_t tokens) {
+    stress_token(buffer, "1");
+    while (buffer->tokens + 2 <= tokens) {
+        stress_token(buffer, " + ");
+        stress_token(buffer, "1");
+    }
+}
+
+/// @brief ((((1)))): every '(' is stacked, then each ')' closes a group holding no operators.
+static void stress_deep_nesting(StressBuffer* buffer, size_t tokens) {
+    const size_t depth = tokens > 1 ? (tokens - 1) / 2 : 0;
+    for (size_t i = 0; i < depth; i++) {
+        stress_token(buffer, "(");
+    }
+    stress_token(buffer, "1");
+    for (size_t i = 0; i < depth; i++) {
+        stress_token(buffer, ")");
+    }
+}
+
+/// @brief (1 + (1 + (1 + ...))): operators and parentheses interleave on the stack.
+static void stress_nested_sums(StressBuffer* buffer, size_t tokens) {
+    const size_t depth = tokens > 1 ? (tokens - 1) / 4 : 0;
+    for (size_t i = 0; i < depth; i++) {
+        stress_token(buffer, "(");
+        stress_token(buffer, "1");
+        stress_token(buffer, " + ");
+    }
+    stress_token(buffer, "1");
+    for (size_t i = 0; i < depth; i++) {
+        stress_token(buffer, ")");
+    }
+}
+
+/// @brief - - - - 1: every minus is unary, right-associative, and waits for the operand.
+static void stress_unary_chain(StressBuffer* buffer, size_t tokens) {
+    while (buffer->tokens + 1 < tokens) {
+        stress_token(buffer, "- ");
+    }
+    stress_token(buffer, "1");
+}
+
+/// @brief 2 ** 2 ** 2 ...: right-associative, so nothing pops until the very end.
+static void stress_power_chain(StressBuffer* buffer, size_t tokens) {
+    stress_token(buffer, "2");
+    while (buffer->tokens + 2 <= tokens) {
+        stress_token(buffer, " ** ");
+        stress_token(buffer, "2");
+    }
+}
+
+/// @brief 1 + 2 * 3 ** 4 + ...: climbs three precedence levels, then pops them all, repeatedly.
+static void stress_precedence_ladder(StressBuffer* buffer, size_t tokens) {
+    static const char* operators[] = {" + ", " * ", " ** "};
+    stress_token(buffer, "1");
+    for (size_t i = 0; buffer->tokens + 2 <= tokens; i++) {
+        stress_token(buffer, operators[i % 3]);
+        stress_token(buffer, "3");
+    }
+}
+
+/// @brief Random well-formed expressions: nesting, unary runs, literals of every form, variables.
+static void stress_fuzz_valid(StressBuffer* buffer, size_t tokens) {
+    static const char* operators[] = {" + ", " - ", " * ", " / ", " % ", " ** "};
+    static const char* operands[] = {"7", "42", "3.25", "1e3", "2.5E-3", "x", "rate_2"};
+    size_t open = 0;
+
+    while (true) {
+        while (harness_rand() % 3 == 0 && buffer->tokens + open + 4 < tokens) {
+            stress_token(buffer, "(");
+            open++;
+        }
+        while (harness_rand() % 4 == 0 && buffer->tokens + open + 4 < tokens) {
+            stress_token(buffer, harness_rand() % 2 ? "-" : "+");
+        }
+        stress_token(buffer, operands[harness_rand() % 7]);
+        while (open > 0 && harness_rand() % 3 == 0) {
+            stress_token(buffer, ")");
+            open--;
+        }
+
+        if (buffer->tokens + open + 2 > tokens) {
+            break;
+        }
+        stress_token(buffer, operators[harness_rand() % 6]);
+    }
+
+    while (open-- > 0) {
+        stress_token(buffer, ")");
+    }
+}
+
+/// @brief Random token soup, mostly malformed: measures how quickly bad input is turned away.
+static void stress_fuzz_soup(StressBuffer* buffer, size_t tokens) {
+    static const char* pieces[] = {"1", "2.5", "9e9", "x", "(", ")", "+", "-", "*", "/", "**", " "};
+    while (buffer->tokens < tokens) {
+        stress_token(buffer, pieces[harness_rand() % 12]);
+    }
+}
+
+typedef void (*StressShapeFunction)(StressBuffer* buffer, size_t tokens);
+
+typedef struct StressShape {
+    const char* name;
+    StressShapeFunction generate;
+    bool fuzzed; // A fresh input per sample instead of one input repeated
+    bool valid; // Every input must convert (and only such shapes are fitted for linearity)
+} StressShape;
+
+static const StressShape stress_shapes[] = {
+    {"flat_sum", stress_flat_sum, false, true},
+    {"deep_nesting", stress_deep_nesting, false, true},
+    {"nested_sums", stress_nested_sums, false, true},
+    {"unary_chain", stress_unary_chain, false, true},
+    {"power_chain", stress_power_chain, false, true},
+    {"precedence_ladder", stress_precedence_ladder, false, true},
+    {"fuzz_valid", stress_fuzz_valid, true, true},
+    {"fuzz_soup", stress_fuzz_soup, true, false},
+};
+
+#define STRESS_SHAPE_COUNT (sizeof(stress_shapes) / sizeof(*stress_shapes))
+
+static StressBuffer stress_generate(const StressShape* shape, size_t tokens) {
+    StressBuffer buffer = {0};
+    shape->generate(&buffer, tokens);
+    return buffer;
+}
+
+// --- Pipelines ---
+
+typedef enum StressPipeline {
+    STRESS_FUSED, // shunt_expression_checked(): lex and convert in one pass
+    STRESS_TWO_PASS, // tokenizer() then shunt_yard(), through their _checked forms
+    STRESS_PIPELINE_COUNT,
+} StressPipeline;
+
+static const char* stress_pipeline_names[STRESS_PIPELINE_COUNT] = {
+    "shunt_expression",
+    "tokenizer+shunt_yard",
+};
+
+/// @brief Where a rejected parse stopped.
+typedef struct StressStop {
+    ShuntError error;
+    bool indexed; // The column is an infix token index (shunt_yard), not a byte offset
+} StressStop;
+
+/// @return true if the input converted; otherwise `stop` says where it was rejected.
+static bool stress_parse(StressPipeline pipeline, const StressBuffer* input, StressStop* stop) {
+    TokenList* postfix = NULL;
+    stop->indexed = false;
+    if (pipeline == STRESS_FUSED) {
+        postfix = shunt_expression_checked(input->data, input->length, NULL, &stop->error);
+    } else {
+        TokenList* infix
+            = tokenizer_checked(input->data, input->length, NULL, false, &stop->error);
+        postfix = infix ? shunt_yard_checked(infix, NULL, &stop->error) : NULL;
+        stop->indexed = infix != NULL;
+        token_list_free(infix);
+    }
+
+    const bool converted = postfix != NULL;
+    harness_sink += converted ? postfix->count : 0;
+    token_list_free(postfix);
+    return converted;
+}
+
+/// @brief Tokens a parse got through, up to and including the one it was rejected at.
+/// @note Counting lexes the consumed prefix again, so it runs outside the timed region.
+static size_t stress_consumed(const StressBuffer* input, bool converted, const StressStop* stop) {
+    size_t consumed = input->tokens;
+    if (converted) {
+        return consumed;
+    }
+
+    if (stop->indexed) {
+        consumed = stop->error.column + 1;
+    } else {
+        const size_t column = stop->error.column < input->length ? stop->error.column
+                                                                  : input->length;
+        TokenList* prefix = tokenizer_checked(input->data, column, NULL, true, NULL);
+        consumed = prefix ? prefix->count + 1 : 1;
+        token_list_free(prefix);
+    }
+    return consumed < input->tokens ? consumed : input->tokens;
+}
+
+// --- Measurement ---
+
+#define STRESS_MIN_SAMPLES 16
+#define STRESS_MAX_SAMPLES 4096
+
+typedef struct StressResult {
+    size_t tokens; // Tokens per input
+    size_t consumed; // Median tokens reached before conversion ended (all, unless rejected)
+    double p50; // Seconds per parse
+    double p99;
+    double max;
+    size_t peak; // Most heap bytes one parse held at once, beyond what was live before it
+} StressResult;
+
+static int stress_compare(const void* a, const void* b) {
+    const double x = *(const double*) a;
+    const double y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+static int stress_compare_size(const void* a, const void* b) {
+    const size_t x = *(const size_t*) a;
+    const size_t y = *(const size_t*) b;
+    return (x > y) - (x < y);
+}
+
+/// @brief Nearest-rank percentile of sorted samples.
+static double stress_percentile(const double* sorted, size_t count, double percent) {
+    size_t rank = (size_t) ceil(percent / 100.0 * (double) count);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static StressResult stress_measure(
+    const StressShape* shape, StressPipeline pipeline, size_t tokens, double seconds
+) {
+    static double samples[STRESS_MAX_SAMPLES];
+    static size_t consumed[STRESS_MAX_SAMPLES];
+    StressResult result = {0};
+    StressStop stop;
+
+    StressBuffer input = stress_generate(shape, tokens);
+    stress_parse(pipeline, &input, &stop); // warm the allocator and caches
+
+    size_t count = 0;
+    double total = 0.0;
+    while (count < STRESS_MIN_SAMPLES || (total < seconds && count < STRESS_MAX_SAMPLES)) {
+        if (shape->fuzzed && count > 0) {
+            free(input.data);
+            input = stress_generate(shape, tokens);
+        }
+        result.tokens = input.tokens;
+
+        const size_t baseline = harness_peak_reset();
+        const double start = harness_now();
+        const bool converted = stress_parse(pipeline, &input, &stop);
+        const double elapsed = harness_now() - start;
+        if (harness_peak_bytes() - baseline > result.peak) {
+            result.peak = harness_peak_bytes() - baseline;
+        }
+
+        if (shape->valid && !converted) {
+            fprintf(
+                stderr,
+                "[STRESS] shape=%s pipeline=%s rejected valid input (tokens=%zu).\n",
+                shape->name,
+                stress_pipeline_names[pipeline],
+                input.tokens
+            );
+            exit(EXIT_FAILURE);
+        }
+
+        consumed[count] = stress_consumed(&input, converted, &stop);
+        samples[count++] = elapsed;
+        total += elapsed;
+    }
+    free(input.data);
+
+    qsort(consumed, count, sizeof(*consumed), stress_compare_size);
+    result.consumed = consumed[(count - 1) / 2];
+    qsort(samples, count, sizeof(*samples), stress_compare);
+    result.p50 = stress_percentile(samples, count, 50.0);
+    result.p99 = stress_percentile(samples, count, 99.0);
+    result.max = samples[count - 1];
+    return result;
+}
+
+// --- Linearity ---
+
+#define STRESS_TIME_SLOPE_LIMIT 1.25 // Quadratic work fits at 2.0
+#define STRESS_HEAP_SLOPE_LIMIT 1.15
+
+/// @brief Least-squares slope of log(y) against log(x): 1.0 is linear, 2.0 quadratic.
+static double stress_slope(const double* x, const double* y, size_t count) {
+    double mx = 0.0, my = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        mx += log(x[i]);
+        my += log(y[i]);
+    }
+    mx /= (double) count;
+    my /= (double) count;
+
+    double covariance = 0.0, variance = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        covariance += (log(x[i]) - mx) * (log(y[i]) - my);
+        variance += (log(x[i]) - mx) * (log(x[i]) - mx);
+    }
+    return variance > 0.0 ? covariance / variance : 0.0;
+}
+
+// --- Main ---
+
+int main(int argc, char* argv[]) {
+    double seconds = argc > 1 ? strtod(argv[1], NULL) : 0.05;
+    if (seconds <= 0.0) {
+        seconds = 0.05;
+    }
+
+    // Small inputs are dominated by fixed per-call costs, so only the larger ones are fitted
+    const size_t sizes[] = {1024, 4096, 16384, 65536, 262144};
+    const size_t size_count = sizeof(sizes) / sizeof(*sizes);
+    const size_t fit_from = 1;
+
+    bool linear = true;
+    for (size_t s = 0; s < STRESS_SHAPE_COUNT; s++) {
+        for (size_t p = 0; p < STRESS_PIPELINE_COUNT; p++) {
+            double tokens[sizeof(sizes) / sizeof(*sizes)];
+            double times[sizeof(sizes) / sizeof(*sizes)];
+            double peaks[sizeof(sizes) / sizeof(*sizes)];
+
+            for (size_t i = 0; i < size_count; i++) {
+                const StressResult result
+                    = stress_measure(&stress_shapes[s], (StressPipeline) p, sizes[i], seconds);
+                tokens[i] = (double) result.tokens;
+                times[i] = result.p50;
+                peaks[i] = (double) (result.peak ? result.peak : 1);
+
+                // Rates are per token consumed, so early rejections are not reported as fast
+                printf(
+                    "[STRESS] shape=%-17s pipeline=%-20s tokens=%-8zu consumed=%-8zu "
+                    "p50=%-10.1f p99=%-10.1f max=%-10.1f ns/token=%-6.2f",
+                    stress_shapes[s].name,
+                    stress_pipeline_names[p],
+                    result.tokens,
+                    result.consumed,
+                    result.p50 * 1e6,
+                    result.p99 * 1e6,
+                    result.max * 1e6,
+                    result.p50 * 1e9 / (double) result.consumed
+                );
+                if (HARNESS_TRACKS_HEAP) {
+                    printf(
+                        " peak=%zuKiB bytes/token=%.1f\n",
+                        result.peak / 1024,
+                        (double) result.peak / (double) result.consumed
+                    );
+                } else {
+                    printf(" peak=n/a\n");
+                }
+            }
+
+            if (!stress_shapes[s].valid) {
+                printf(
+                    "[LINEAR] shape=%-17s pipeline=%-20s excluded: inputs are rejected early\n",
+                    stress_shapes[s].name,
+                    stress_pipeline_names[p]
+                );
+                continue;
+            }
+
+            const double time_slope
+                = stress_slope(tokens + fit_from, times + fit_from, size_count - fit_from);
+            const double heap_slope
+                = stress_slope(tokens + fit_from, peaks + fit_from, size_count - fit_from);
+            const bool ok = time_slope <= STRESS_TIME_SLOPE_LIMIT
+                            && (!HARNESS_TRACKS_HEAP || heap_slope <= STRESS_HEAP_SLOPE_LIMIT);
+            linear = linear && ok;
+
+            printf(
+                "[LINEAR] shape=%-17s pipeline=%-20s time_slope=%.2f heap_slope=%.2f %s\n",
+                stress_shapes[s].name,
+                stress_pipeline_names[p],
+                time_slope,
+                HARNESS_TRACKS_HEAP ? heap_slope : 0.0,
+                ok ? "ok" : "SUPERLINEAR"
+            );
+        }
+    }
+
+    return linear ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,53 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file include/arena.h
+ * @brief Bump allocator for expression-scoped memory.
+ * @note Allocations are never freed individually. Everything drawn from an arena is released at
+ *       once by arena_reset() (keeps the blocks for reuse) or arena_free() (returns them).
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdalign.h>
+#include <stddef.h>
+
+#define ARENA_BLOCK_SIZE 4096
+#define ARENA_ALIGNMENT alignof(max_align_t)
+
+// --- Arena Block ---
+
+typedef struct ArenaBlock {
+    struct ArenaBlock* next; // Next block in the chain
+    size_t capacity; // Usable bytes in data
+    size_t offset; // Bytes handed out so far
+    alignas(max_align_t) unsigned char data[]; // Block payload
+} ArenaBlock;
+
+// --- Arena ---
+
+typedef struct Arena {
+    ArenaBlock* head; // First block (kept across resets)
+    ArenaBlock* current; // Block serving allocations
+    size_t block_size; // Minimum capacity of new blocks
+} Arena;
+
+// --- Arena Lifecycle ---
+
+Arena* arena_create(size_t block_size);
+void arena_reset(Arena* arena);
+void arena_free(Arena* arena);
+
+// --- Arena Allocation ---
+
+void* arena_alloc(Arena* arena, size_t size);
+void* arena_alloc_aligned(Arena* arena, size_t size, size_t alignment);
+char* arena_strndup(Arena* arena, const char* src, size_t size);
+
+// --- Arena Introspection ---
+
+size_t arena_used(const Arena* arena);
+size_t arena_capacity(const Arena* arena);
+
+#endif // ARENA_H
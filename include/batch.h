@@ -0,0 +1,57 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file include/batch.h
+ * @brief Converts large sets of independent infix expressions to postfix across a worker pool.
+ * @note Workers claim fixed-size chunks of the input from a shared atomic cursor, so uneven
+ *       expression lengths balance out without any locking. Each worker parses through its own
+ *       ShuntContext, whose arena holds every token it produced until the batch is freed.
+ */
+
+#ifndef SHUNT_BATCH_H
+#define SHUNT_BATCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "lexer/token_list.h"
+#include "parser.h"
+
+#define SHUNT_BATCH_CHUNK 256 // Expressions claimed per worker step
+
+// --- Results ---
+
+typedef struct ShuntBatchResult {
+    ShuntError error; // code is SHUNT_STATUS_OK on success; columns are byte offsets
+    size_t count; // Postfix length (0 unless SHUNT_STATUS_OK)
+    size_t depth; // Peak evaluation stack depth
+    Token** postfix; // Owned by the batch (NULL unless SHUNT_STATUS_OK)
+    Arena* arena; // Worker arena holding the tokens
+} ShuntBatchResult;
+
+typedef struct ShuntBatch {
+    size_t count;
+    ShuntBatchResult* results; // One per input expression, in input order
+    size_t failures; // Results whose error code is not SHUNT_STATUS_OK
+    size_t worker_count;
+    ShuntContext** workers; // Per-worker contexts; their arenas own every postfix token
+} ShuntBatch;
+
+// --- Batch Conversion ---
+
+/// @param lengths Byte length of each expression (may be NULL for NUL-terminated input).
+/// @param threads Worker count; 0 uses every online core.
+/// @return NULL only if the batch itself cannot be set up. Per-expression failures are reported
+///         through each result's error.
+/// @warning Lexemes are views, so the expressions must outlive the batch.
+ShuntBatch* shunt_batch(
+    const char* const* expressions, const size_t* lengths, size_t count, size_t threads
+);
+void shunt_batch_free(ShuntBatch* batch);
+
+/// @brief Borrows a result as a TokenList, e.g. for bytecode_compile() or rpn_evaluate().
+/// @warning The list does not own its tokens. Do not free, push or pop.
+TokenList shunt_batch_list(const ShuntBatch* batch, size_t index);
+
+#endif // SHUNT_BATCH_H
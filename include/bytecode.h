@@ -0,0 +1,150 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file include/bytecode.h
+ * @brief Compiles postfix TokenLists into a flat instruction array and executes it.
+ * @note Literals are decoded once at compile time and unary/binary roles resolved by shunt_yard()
+ *       are baked into the opcodes, so repeated evaluation never touches a lexeme.
+ * @note Identifiers become variable slots numbered in order of first appearance. Programs with
+ *       variables always run in float mode.
+ * @note Programs serialize to a versioned, position-independent image (see bytecode_serialize())
+ *       that bytecode_load() executes in place, e.g. straight out of an mmap'd file.
+ */
+
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#include "lexer/token_list.h"
+#include "evaluator.h"
+
+// --- Opcodes ---
+
+typedef enum OpCode {
+    OP_PUSH, // Push the immediate
+    OP_LOAD, // Push the variable in the slot
+    OP_NEG, // Unary minus (unary plus compiles to nothing)
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_MOD,
+    OP_POW,
+} OpCode;
+
+// --- Instruction ---
+
+typedef struct Instruction {
+    uint8_t opcode; // OpCode
+    union {
+        int64_t integer; // Immediate in integral programs
+        double real; // Immediate in float programs
+        uint64_t slot; // Variable index for OP_LOAD
+    } operand;
+} Instruction;
+
+// --- Program ---
+
+typedef struct Bytecode {
+    size_t count;
+    size_t capacity;
+    Instruction* code;
+    size_t depth; // Peak stack depth
+    bool integral; // int64 arithmetic if true, double otherwise
+    size_t variable_count;
+    char** variables; // Variable names indexed by slot
+    bool borrowed; // code and names point into a loaded image (see bytecode_load())
+    size_t jit_threshold; // Executions before running natively (0 never; see jit.h)
+    _Atomic size_t jit_uses; // Executions counted toward the threshold
+    struct BytecodeJit* _Atomic jit; // Native code, once compiled (owned)
+} Bytecode;
+
+// --- Program Lifecycle ---
+
+/// @note Returns NULL if the postfix expression is malformed or a literal cannot be decoded.
+/// @note Constant subexpressions are folded (see bytecode_fold()).
+Bytecode* bytecode_compile(const TokenList* postfix);
+void bytecode_free(Bytecode* program);
+
+/// @brief Finds the literal bytecode_compile() cannot decode: an integer beyond int64_t in a
+///        program with no floats or variables (float programs widen it instead).
+/// @return The first such literal, or NULL if every literal fits, so any other compile failure of
+///         well-formed postfix is an allocation failure.
+const Token* bytecode_range_fault(const TokenList* postfix);
+
+/// @return The slot of the named variable, or -1 if the program does not reference it.
+int64_t bytecode_variable_slot(const Bytecode* program, const char* name);
+
+// --- Optimization ---
+
+/// @brief Folds operators whose operands are all immediates into a single PUSH, bottom-up, so whole
+///        constant subtrees (including unary minus) collapse. Integer faults are not folded.
+/// @return The number of operators folded (always 0 for a loaded, read-only program).
+size_t bytecode_fold(Bytecode* program);
+
+// --- Execution ---
+
+/// @param variables One value per slot (may be NULL if the program has no variables).
+/// @note Same semantics as rpn_evaluate(): integer division by zero fails.
+/// @note Float programs are compiled to native code on their jit_threshold-th execution, by
+///       whichever thread gets there, and run natively from then on (see jit.h).
+bool bytecode_execute(const Bytecode* program, const double* variables, RpnValue* result);
+
+// --- Batch Execution ---
+
+#define BYTECODE_BATCH_ROWS 256 // Rows per column block; keeps the working set in L1/L2
+
+/// @brief Evaluates the program over rows of input, one opcode over a whole column block at a time.
+/// @param columns One array of `rows` doubles per variable slot (may be NULL without variables).
+/// @param out Receives `rows` results. Integral programs are converted to double.
+bool bytecode_execute_batch(
+    const Bytecode* program, const double* const* columns, size_t rows, double* out
+);
+
+// --- Serialization ---
+
+/// Image layout, little-endian, every section 8-byte aligned:
+///     BytecodeImage header
+///     count instructions, 16 bytes each: opcode, 7 zero bytes, 8-byte operand
+///     variable_count NUL-terminated names, zero-padded to a multiple of 8
+/// Instructions match the in-memory Instruction, so a loaded program runs from the image itself.
+
+#define BYTECODE_IMAGE_MAGIC "SYBC"
+#define BYTECODE_IMAGE_VERSION 1
+#define BYTECODE_IMAGE_ORDER 0x01020304u // Reads back differently under a foreign byte order
+#define BYTECODE_IMAGE_INTEGRAL 0x1 // Flag: int64 program
+
+typedef struct BytecodeImage {
+    char magic[4]; // BYTECODE_IMAGE_MAGIC, not NUL-terminated
+    uint16_t version;
+    uint16_t flags;
+    uint32_t order; // BYTECODE_IMAGE_ORDER
+    uint32_t count; // Instructions
+    uint32_t depth; // Peak stack depth
+    uint32_t variable_count;
+    uint64_t size; // Whole image in bytes, so images can be concatenated
+} BytecodeImage;
+
+/// @return Bytes bytecode_serialize() writes for the program (a multiple of 8), or 0 if the
+///         program cannot be serialized.
+size_t bytecode_image_size(const Bytecode* program);
+
+/// @brief Writes the program's image into buffer.
+/// @return Bytes written, or 0 if the buffer is smaller than bytecode_image_size().
+size_t bytecode_serialize(const Bytecode* program, void* buffer, size_t capacity);
+
+/// @brief Loads a program without copying its code or names: both point into the image.
+/// @param image 8-byte aligned (any mmap'd or malloc'd buffer is); may hold further images after.
+/// @param consumed Receives the image's size, i.e. the offset of the next image (may be NULL).
+/// @return NULL if the image is truncated, misaligned, from another version or byte order, or its
+///         code would not run safely (bad opcode or slot, stack imbalance, wrong depth).
+/// @warning The image must outlive the program and must not change; bytecode_free() leaves it.
+Bytecode* bytecode_load(const void* image, size_t size, size_t* consumed);
+
+void bytecode_dump(const Bytecode* program);
+
+#endif // BYTECODE_H
@@ -0,0 +1,101 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file include/cache.h
+ * @brief Thread-safe cache of compiled expressions keyed by their normalized source text.
+ * @note Repeated formulas skip tokenizing, parsing and compiling entirely: a hit hashes the source
+ *       once and hands back the shared Bytecode. Whitespace that cannot change the token stream is
+ *       dropped from the key, so "a+b" and " a + b " share one entry.
+ * @note Eviction is CLOCK (second chance): every hit sets the entry's reference bit, and the hand
+ *       clears bits until it finds an entry that was not used since its last sweep.
+ */
+
+#ifndef SHUNT_CACHE_H
+#define SHUNT_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#include "bytecode.h"
+#include "error.h"
+
+#define SHUNT_CACHE_CAPACITY 4096 // Default entry limit
+
+// --- Entry ---
+
+typedef struct ShuntCacheEntry {
+    uint64_t hash; // FNV-1a of the normalized source
+    size_t length;
+    char* key; // Normalized source (not NUL-terminated)
+    Bytecode* program;
+    size_t pins; // Callers holding the entry (guarded by the cache lock)
+    bool referenced; // CLOCK bit, set on every hit
+    bool cached; // Still indexed; an evicted entry is freed by its last release
+    struct ShuntCacheEntry* next; // Bucket chain
+} ShuntCacheEntry;
+
+// --- Cache ---
+
+typedef struct ShuntCacheStats {
+    size_t hits;
+    size_t misses; // Includes sources that failed to compile
+    size_t evictions;
+    size_t count; // Entries currently cached
+    size_t capacity;
+} ShuntCacheStats;
+
+typedef struct ShuntCache {
+    pthread_mutex_t lock;
+    size_t capacity; // Entry limit
+    size_t count;
+    size_t hand; // Next CLOCK slot to inspect
+    ShuntCacheEntry** slots; // CLOCK ring, one slot per entry
+    ShuntCacheEntry** buckets; // Hash index (power of two, at least twice the capacity)
+    size_t mask;
+    ShuntCacheStats stats;
+} ShuntCache;
+
+// --- Cache Lifecycle ---
+
+/// @param capacity Maximum number of cached programs; 0 selects SHUNT_CACHE_CAPACITY.
+ShuntCache* shunt_cache_create(size_t capacity);
+
+/// @warning Every acquired entry must be released first.
+void shunt_cache_free(ShuntCache* cache);
+
+/// @brief Drops every entry that is not currently acquired and resets the counters.
+void shunt_cache_clear(ShuntCache* cache);
+
+// --- Lookup ---
+
+/// @brief Returns the compiled program for the expression, parsing and compiling it on a miss.
+/// @param error Receives the failure (may be NULL). Columns are byte offsets into the expression
+///        as given, not into its normalized key.
+/// @return A pinned entry, or NULL if the expression is malformed (failures are not cached).
+/// @note The program is shared and read-only; bytecode_execute() may run it from many threads.
+/// @warning Pass the entry to shunt_cache_release() when done; it stays valid until then even if
+///          it is evicted meanwhile.
+const ShuntCacheEntry* shunt_cache_acquire(
+    ShuntCache* cache, const char* expression, size_t length, ShuntError* error
+);
+void shunt_cache_release(ShuntCache* cache, const ShuntCacheEntry* entry);
+
+/// @brief Acquires, executes and releases in one call.
+/// @param variables One value per program slot (see bytecode_variable_slot()).
+/// @return false if the expression failed (see error) or execution faulted, e.g. on integer
+///         division by zero, which leaves error at SHUNT_STATUS_OK.
+bool shunt_cache_evaluate(
+    ShuntCache* cache,
+    const char* expression,
+    size_t length,
+    const double* variables,
+    RpnValue* result,
+    ShuntError* error
+);
+
+/// @brief Copies the counters under the lock, so the snapshot is consistent.
+void shunt_cache_stats(ShuntCache* cache, ShuntCacheStats* stats);
+
+#endif // SHUNT_CACHE_H
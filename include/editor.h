@@ -0,0 +1,62 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file include/editor.h
+ * @brief Incremental re-conversion of an expression that is edited in place (e.g. per keystroke).
+ * @note Tokens are kept as packed TokenArrays whose offsets index the editor's own copy of the
+ *       text, so they survive edits: tokens before an edit keep their offsets and tokens after it
+ *       shift by the size delta.
+ * @note An edit re-lexes from the token it touches until the new tokens line up with the old ones
+ *       again, then re-shunts only the innermost parenthesized group that encloses the new
+ *       tokens, splicing its postfix over the old span. Edits outside every group, edits that add
+ *       or remove a parenthesis, and edits after a failed conversion fall back to a full re-shunt.
+ */
+
+#ifndef SHUNT_EDITOR_H
+#define SHUNT_EDITOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "lexer/token_array.h"
+#include "error.h"
+
+// --- Editor ---
+
+typedef struct ShuntEditor {
+    char* source; // Owned, NUL-terminated text
+    size_t length;
+    size_t capacity;
+    TokenArray* infix; // Offsets into source
+    TokenArray* postfix; // Offsets into source; only meaningful while valid
+    ShuntError error; // Why the text does not convert (code is SHUNT_STATUS_OK while valid)
+    bool lexed; // infix matches source (false after a lexing error)
+    bool valid; // postfix matches infix and reduces to a single value
+    size_t relexed; // Tokens lexed by the last edit
+    size_t reshunted; // Infix tokens re-shunted by the last edit
+} ShuntEditor;
+
+// --- Editor Lifecycle ---
+
+/// @brief Copies the text and converts it in full.
+/// @return NULL only if memory runs out or the text exceeds 4 GiB; conversion failures are
+///         reported through editor->error.
+ShuntEditor* shunt_editor_create(const char* source, size_t length);
+void shunt_editor_free(ShuntEditor* editor);
+
+// --- Editing ---
+
+/// @brief Replaces the bytes [start, end) with text and re-converts incrementally.
+/// @return true if the edited text converts (editor->valid). false on a bad range, out of
+///         memory, or when the new text does not convert; see editor->error.
+/// @note Accepts exactly what shunt_yard_array() plus shunt_is_valid_postfix_array() accept.
+bool shunt_editor_edit(
+    ShuntEditor* editor, size_t start, size_t end, const char* text, size_t length
+);
+
+/// @return The postfix of the current text, or NULL while it does not convert.
+/// @warning Owned by the editor and only valid until the next edit.
+const TokenArray* shunt_editor_postfix(const ShuntEditor* editor);
+
+#endif // SHUNT_EDITOR_H
@@ -0,0 +1,50 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file include/error.h
+ * @brief Compact error reports shared by the lexer and parser.
+ * @note Errors are plain values filled in on failure; the library itself never prints them, so
+ *       callers can log rejects in bulk or drop them for free.
+ */
+
+#ifndef SHUNT_ERROR_H
+#define SHUNT_ERROR_H
+
+#include <stddef.h>
+
+#include "lexer/token.h"
+
+// --- Status ---
+
+typedef enum ShuntStatus {
+    SHUNT_STATUS_OK,
+    SHUNT_STATUS_SYNTAX, // Unknown character in the input
+    SHUNT_STATUS_UNBALANCED, // ')' without a matching '(' or a '(' left open
+    SHUNT_STATUS_EMPTY, // No tokens at all
+    SHUNT_STATUS_MALFORMED, // Postfix does not reduce to a single value
+    SHUNT_STATUS_MEMORY, // Ran out of memory
+    SHUNT_STATUS_RANGE, // A literal does not fit its type
+    SHUNT_STATUS_LIMIT, // Input exceeds a configured ShuntLimits bound
+} ShuntStatus;
+
+// --- Error ---
+
+typedef struct ShuntError {
+    ShuntStatus code;
+    TokenType type; // Offending token type (NONE if the fault is not a token)
+    size_t column; // Byte offset into the source; TokenList inputs report the token index
+    size_t size; // Offending lexeme length (0 at end of input)
+} ShuntError;
+
+/// @note Safe to call with a NULL error, so reporting costs nothing when the caller opts out.
+static inline void shunt_error_set(
+    ShuntError* error, ShuntStatus code, TokenType type, size_t column, size_t size
+) {
+    if (error) {
+        *error = (ShuntError) {.code = code, .type = type, .column = column, .size = size};
+    }
+}
+
+const char* shunt_status_to_string(ShuntStatus status);
+
+#endif // SHUNT_ERROR_H
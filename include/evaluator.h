@@ -0,0 +1,46 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file include/evaluator.h
+ * @brief Evaluator for postfix expressions produced by shunt_yard().
+ * @note Expressions made only of INTEGER literals are evaluated with int64 arithmetic; any FLOAT
+ *       literal promotes the whole expression to double arithmetic.
+ */
+
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lexer/token_list.h"
+
+#define RPN_STACK_SIZE 64 // Stack slots kept on the C stack before falling back to the heap
+
+// --- Value ---
+
+typedef struct RpnValue {
+    TokenType type; // TOKEN_TYPE_INTEGER or TOKEN_TYPE_FLOAT
+    union {
+        int64_t integer;
+        double real;
+    };
+} RpnValue;
+
+// --- Arithmetic ---
+
+/// @brief Integer exponentiation by squaring, wrapping on overflow like the other operators.
+/// @note A negative exponent truncates toward zero like integer division (2 ** -1 is 0); it fails
+///       only for a zero base, which would divide by zero.
+bool rpn_integer_power(int64_t base, int64_t exponent, int64_t* out);
+
+// --- Evaluation ---
+
+/// @note Fails on malformed postfix, integer overflow of a literal, or integer division by zero.
+/// @note Identifiers are unbound here and fail; compile with bytecode_compile() to supply them.
+bool rpn_evaluate(const TokenList* postfix, RpnValue* result);
+
+double rpn_value_as_float(const RpnValue* value);
+void rpn_value_dump(const RpnValue* value);
+
+#endif // EVALUATOR_H
@@ -0,0 +1,56 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file include/jit.h
+ * @brief Compiles float bytecode programs to native x86-64 code.
+ * @note The evaluation stack lives in registers: stack slot i is xmm<i>, so a program runs
+ *       straight through without dispatch, touching memory only for immediates and variables.
+ *       fmod() and pow() calls spill the slots below their operands and reload them afterwards.
+ * @note bytecode_execute() switches to native code by itself once a program has run
+ *       Bytecode.jit_threshold times; calling bytecode_jit_compile() directly skips the wait.
+ * @note Pages are written first and then made read+execute, never writable and executable at once.
+ */
+
+#ifndef BYTECODE_JIT_H
+#define BYTECODE_JIT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "bytecode.h"
+
+/// @note Native code needs the System V calling convention and mmap(); elsewhere every compile
+///       returns NULL and programs stay interpreted. Define SHUNT_NO_JIT to opt out.
+#if defined(__x86_64__) && defined(__GNUC__) && (defined(__unix__) || defined(__APPLE__)) \
+    && !defined(SHUNT_NO_JIT)
+    #define BYTECODE_JIT_X86_64 1
+#endif
+
+#define BYTECODE_JIT_THRESHOLD 1024 // Default executions before a program is compiled natively
+#define BYTECODE_JIT_REGISTERS 16 // Deepest stack kept in xmm registers
+
+// --- Native Program ---
+
+/// @param variables One value per slot (unused if the program has none).
+typedef double (*BytecodeJitFunction)(const double* variables);
+
+typedef struct BytecodeJit {
+    BytecodeJitFunction function;
+    void* memory; // Executable mapping holding the code and its constants
+    size_t size; // Mapping length
+} BytecodeJit;
+
+// --- Native Lifecycle ---
+
+/// @return true if this build can emit native code.
+bool bytecode_jit_supported(void);
+
+/// @brief Translates the program to machine code, with the interpreter's exact float results.
+/// @return NULL if native code is unsupported here, the program is integral (bytecode_fold() has
+///         already reduced those to constants or runtime faults), its stack is deeper than
+///         BYTECODE_JIT_REGISTERS, or executable memory cannot be mapped.
+BytecodeJit* bytecode_jit_compile(const Bytecode* program);
+void bytecode_jit_free(BytecodeJit* jit);
+
+#endif // BYTECODE_JIT_H
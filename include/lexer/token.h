@@ -13,6 +13,8 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "arena.h"
+
 // --- Precedence ---
 
 typedef enum Precedent {
@@ -21,7 +23,8 @@ typedef enum Precedent {
     TOKEN_PRECEDENT_ADDITIVE = 1, // +, -
     TOKEN_PRECEDENT_MULTIPLICATIVE = 2, // *, /, %
     TOKEN_PRECEDENT_UNARY = 3, // +, -
-    // More to come: unary, function call, etc.
+    TOKEN_PRECEDENT_POWER = 4, // ** (binds tighter than a unary on its left: -2 ** 2 is -4)
+    // More to come: function call, etc.
 } Precedent;
 
 // --- Associativity ---
@@ -47,6 +50,7 @@ typedef enum TokenKind {
     TOKEN_KIND_LITERAL,
     TOKEN_KIND_OPERATOR,
     TOKEN_KIND_GROUP,
+    TOKEN_KIND_IDENTIFIER,
 } TokenKind;
 
 // --- Type: concrete token type ---
@@ -64,32 +68,108 @@ typedef enum TokenType {
     TOKEN_TYPE_STAR,
     TOKEN_TYPE_SLASH,
     TOKEN_TYPE_MOD,
+    TOKEN_TYPE_POWER, // "**", the only two-character symbol
 
     // Grouping
     TOKEN_TYPE_LEFT_PAREN,
     TOKEN_TYPE_RIGHT_PAREN,
+
+    // Variables
+    TOKEN_TYPE_IDENTIFIER,
 } TokenType;
 
+// --- Operator Descriptor Table ---
+
+/// @brief Static traits of a token type in one role, so classification is a single indexed load
+///        instead of per-token fields or a switch.
+/// @note Rows are TokenRole and columns TokenType. Both dimensions are padded to the widths that
+///       TokenTag packs them into (2 and 4 bits), so any tag indexes the table in bounds; padding
+///       entries describe nothing (kind NONE).
+typedef struct TokenDescriptor {
+    uint8_t kind; // TokenKind
+    int8_t precedence; // Precedent
+    uint8_t association; // Associate
+    uint8_t arity; // Operands consumed (0 if the type has no operator form in this role)
+} TokenDescriptor;
+
+#define TOKEN_DESCRIPTOR_ROLES 4
+#define TOKEN_DESCRIPTOR_TYPES 16
+
+extern const TokenDescriptor token_descriptor_table[TOKEN_DESCRIPTOR_ROLES][TOKEN_DESCRIPTOR_TYPES];
+
+static inline const TokenDescriptor* token_descriptor(TokenType type, TokenRole role) {
+    return &token_descriptor_table[role & (TOKEN_DESCRIPTOR_ROLES - 1)]
+                                  [type & (TOKEN_DESCRIPTOR_TYPES - 1)];
+}
+
 // --- Token object ---
 
+/// @brief Literal value, decoded once when the token is created.
+typedef union TokenValue {
+    int64_t integer; // TOKEN_TYPE_INTEGER
+    double real; // TOKEN_TYPE_FLOAT
+} TokenValue;
+
+/// @note Precedence, associativity and kind are not stored: they come from the descriptor table.
 typedef struct Token {
-    Precedent precedence; // Operator precedence (-1 if malformed)
-    Associate association; // Operator associativity
-    TokenRole role; // Unary, binary, etc.
-    TokenKind kind; // Literal, operator, group
-    TokenType type; // Specific token type
+    const char* lexeme; // Null-terminated copy of token string (not terminated if view)
     size_t size; // Length of lexeme
-    char* lexeme; // Null-terminated copy of token string
+    TokenValue value; // Literal payload (valid only if decoded)
+    uint8_t type; // TokenType
+    uint8_t role; // TokenRole: unary or binary, resolved by the parser
+    bool view; // Lexeme borrows the source text
+    bool decoded; // value holds the literal (false for other types and out-of-range integers)
 } Token;
 
+// --- Character Classification Table ---
+
+/// @brief One byte per character: the class in the high nibble and, for symbols, literals and
+///        identifiers, the TokenType it starts in the low nibble.
+typedef enum TokenCharClass {
+    TOKEN_CHAR_INVALID = 0x00, // Not part of the grammar
+    TOKEN_CHAR_SPACE = 0x10, // Skipped between tokens
+    TOKEN_CHAR_DIGIT = 0x20, // Starts a numeric literal
+    TOKEN_CHAR_IDENT = 0x30, // Starts an identifier
+    TOKEN_CHAR_SYMBOL = 0x40, // Single-character operator or group
+} TokenCharClass;
+
+/// @note Digit and whitespace runs are scanned 16 bytes at a time when SSE2 is available.
+#if defined(__SSE2__) && defined(__GNUC__)
+    #define TOKEN_SCAN_SSE2 1
+#endif
+
+#define TOKEN_CHAR_CLASS_MASK 0xF0
+#define TOKEN_CHAR_TYPE_MASK 0x0F
+
+extern const uint8_t token_char_table[256];
+
+static inline uint8_t token_char_class(const char s) {
+    return token_char_table[(unsigned char) s] & TOKEN_CHAR_CLASS_MASK;
+}
+
+static inline TokenType token_char_type(const char s) {
+    return (TokenType) (token_char_table[(unsigned char) s] & TOKEN_CHAR_TYPE_MASK);
+}
+
 // --- ASCII Character Classification ---
 
 bool isop(const char s);
 bool isgroup(const char s);
+bool isident(const char s); // Leading identifier character: [A-Za-z_]
+
+// --- Lexeme Scanning ---
+
+TokenType token_type_from_char(const char s); // Single-character operators and groups
+size_t token_scan_symbol(const char* lexeme, size_t length, TokenType* type); // Operator or group
+/// @note Scans stop at length or at a NUL, whichever comes first (SIZE_MAX for C strings).
+/// @note Numbers are digits[.digits][(e|E)[+|-]digits]. An 'e' without exponent digits is not
+///       part of the number, so "2e" is 2 followed by the identifier e.
+size_t token_scan_number(const char* lexeme, size_t length, TokenType* type); // Numeric literal
+size_t token_scan_identifier(const char* lexeme, size_t length); // [A-Za-z_][A-Za-z0-9_]*
 
 // --- Token Precedent Classification ---
 
-Precedent token_precedence(const Token* token); // Internal logic table
+Precedent token_precedence(const Token* token); // Resolved for the token's role
 
 // --- Token Lifecycle Management ---
 
@@ -97,14 +177,53 @@ Token* token_create(const char* lexeme, const size_t size);
 Token* token_create_number(const char* lexeme);
 Token* token_create_operator(const char* lexeme);
 Token* token_create_group(const char* lexeme);
-Token* token_clone(const Token* token); // Deep copy
+Token* token_create_identifier(const char* lexeme);
+Token* token_clone(const Token* token); // Deep copy (a view stays a view)
 void token_free(Token* token);
 
+/// @brief Builds a token of a known type and span (used by the lexer).
+/// @note A NULL arena allocates on the heap; view selects borrowing over copying the lexeme.
+Token* token_create_typed(
+    Arena* arena, const char* lexeme, const size_t size, TokenType type, bool view
+);
+
+// --- Arena-backed Token Lifecycle ---
+
+/// @warning Arena tokens are owned by the arena. Never pass them to token_free().
+Token* token_arena_create(Arena* arena, const char* lexeme, const size_t size);
+Token* token_arena_create_number(Arena* arena, const char* lexeme);
+Token* token_arena_create_operator(Arena* arena, const char* lexeme);
+Token* token_arena_create_group(Arena* arena, const char* lexeme);
+Token* token_arena_create_identifier(Arena* arena, const char* lexeme);
+Token* token_arena_clone(Arena* arena, const Token* token);
+
+// --- View Token Lifecycle ---
+
+/// @note The lexeme points into the source and is not NUL-terminated; print it with "%.*s".
+/// @warning The source must outlive the token. A NULL arena allocates the token on the heap.
+Token* token_view_create(Arena* arena, const char* lexeme, const size_t size);
+Token* token_view_create_number(Arena* arena, const char* lexeme);
+Token* token_view_create_operator(Arena* arena, const char* lexeme);
+Token* token_view_create_group(Arena* arena, const char* lexeme);
+Token* token_view_create_identifier(Arena* arena, const char* lexeme);
+
+// --- Token Literal Decoding ---
+
+/// @brief Decodes a scanned literal of the given type (INTEGER or FLOAT).
+/// @return false if the lexeme is not a whole literal of that type or an integer overflows.
+/// @note Floats are exact (correctly rounded) whether or not they take the fast path.
+bool token_decode_number(const char* lexeme, size_t size, TokenType type, TokenValue* value);
+
+/// @note Read the payload decoded at creation, and only parse lexemes that were not decoded.
+bool token_to_integer(const Token* token, int64_t* value); // INTEGER only, fails on overflow
+bool token_to_float(const Token* token, double* value); // INTEGER or FLOAT
+
 // --- Token Classification ---
 
 bool token_is_number(const Token* token);
 bool token_is_operator(const Token* token);
 bool token_is_group(const Token* token);
+bool token_is_operand(const Token* token); // Number or identifier
 
 // --- Token Role Classification ---
 
@@ -120,6 +239,7 @@ bool token_is_kind_none(const Token* token);
 bool token_is_kind_literal(const Token* token);
 bool token_is_kind_operator(const Token* token);
 bool token_is_kind_group(const Token* token);
+bool token_is_kind_identifier(const Token* token);
 
 // --- Token Type Classification ---
 
@@ -132,8 +252,10 @@ bool token_is_type_minus(const Token* token);
 bool token_is_type_star(const Token* token);
 bool token_is_type_slash(const Token* token);
 bool token_is_type_mod(const Token* token);
+bool token_is_type_power(const Token* token);
 bool token_is_type_left_paren(const Token* token);
 bool token_is_type_right_paren(const Token* token);
+bool token_is_type_identifier(const Token* token);
 
 // --- Token Associativity Classification ---
 
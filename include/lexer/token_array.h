@@ -0,0 +1,87 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file include/lexer/token_array.h
+ * @brief Packed, value-based token storage for arithmetic expressions.
+ * @note Tokens are stored as parallel arrays (struct-of-arrays): one tag byte holding the type and
+ *       role, plus the lexeme offset and size into a single text buffer. Precedence, associativity
+ *       and kind are looked up in the token descriptor table instead of being stored per token.
+ * @note Migration: token_array_from_list() and token_array_to_list() convert to and from the
+ *       pointer-based TokenList, so existing token_list_* callers can adopt this incrementally.
+ */
+
+#ifndef LEXER_TOKEN_ARRAY_H
+#define LEXER_TOKEN_ARRAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "lexer/token.h"
+#include "lexer/token_list.h"
+
+// --- Token Tag ---
+
+#define TOKEN_TAG_TYPE_MASK 0x0F // TokenType occupies the low nibble
+#define TOKEN_TAG_ROLE_SHIFT 4 // TokenRole occupies bits 4-5
+
+typedef uint8_t TokenTag;
+
+static inline TokenTag token_tag_pack(TokenType type, TokenRole role) {
+    return (TokenTag) ((unsigned) type | ((unsigned) role << TOKEN_TAG_ROLE_SHIFT));
+}
+
+static inline TokenType token_tag_type(TokenTag tag) {
+    return (TokenType) (tag & TOKEN_TAG_TYPE_MASK);
+}
+
+static inline TokenRole token_tag_role(TokenTag tag) {
+    return (TokenRole) (tag >> TOKEN_TAG_ROLE_SHIFT);
+}
+
+/// @brief Tag for a freshly lexed token: operators start out binary until the parser resolves them.
+static inline TokenTag token_tag_lexed(TokenType type) {
+    const bool binary = token_descriptor(type, TOKEN_ROLE_BINARY)->arity == 2;
+    return token_tag_pack(type, binary ? TOKEN_ROLE_BINARY : TOKEN_ROLE_NONE);
+}
+
+Precedent token_tag_precedence(TokenTag tag);
+Associate token_tag_associate(TokenTag tag);
+TokenKind token_tag_kind(TokenTag tag);
+
+// --- Token Array ---
+
+typedef struct TokenArray {
+    size_t count;
+    size_t capacity;
+    const char* source; // Text the offsets index into
+    char* text; // Owned lexeme buffer (NULL if source is borrowed)
+    TokenTag* tags; // Packed type and role per token
+    uint32_t* offsets; // Lexeme offset into source
+    uint32_t* sizes; // Lexeme length
+} TokenArray;
+
+// --- Token Array Operations ---
+
+/// @warning The source is borrowed and must outlive the array.
+TokenArray* token_array_create(const char* source);
+void token_array_free(TokenArray* array);
+
+bool token_array_is_empty(const TokenArray* array);
+bool token_array_reserve(TokenArray* array, size_t capacity);
+bool token_array_push(TokenArray* array, TokenTag tag, uint32_t offset, uint32_t size);
+
+/// @note Points into source and is not NUL-terminated.
+const char* token_array_lexeme(const TokenArray* array, size_t index);
+
+// --- Token List Migration ---
+
+/// @note Lexemes are packed into a buffer owned by the array, so the list may be freed after.
+TokenArray* token_array_from_list(const TokenList* list);
+
+/// @warning The list holds view tokens into the array's text and must not outlive the array.
+TokenList* token_array_to_list(const TokenArray* array);
+
+void token_array_dump(const TokenArray* array);
+
+#endif // LEXER_TOKEN_ARRAY_H
@@ -0,0 +1,65 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file include/lexer/token_deque.h
+ * @brief Ring-buffer deque of tokens with O(1) push and pop at both ends.
+ * @warning Ownership Model (move semantics, nothing is cloned):
+ *     - If you push it, the deque owns it.
+ *     - If you pop it, you own it.
+ *     - If you free the deque, it kills whatever is left.
+ *     - Arena-backed deques never free tokens; the arena reclaims them on reset.
+ */
+
+#ifndef LEXER_TOKEN_DEQUE_H
+#define LEXER_TOKEN_DEQUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "lexer/token.h"
+#include "lexer/token_list.h"
+
+// --- Token Deque ---
+
+typedef struct TokenDeque {
+    size_t head; // Slot of the front token
+    size_t count;
+    size_t capacity; // Always a power of two, so wrapping is a mask
+    Token** tokens;
+    Arena* arena; // Token storage (NULL if the deque owns heap tokens)
+} TokenDeque;
+
+// --- Token Deque Lifecycle ---
+
+TokenDeque* token_deque_create(void);
+TokenDeque* token_deque_create_arena(Arena* arena);
+void token_deque_free(TokenDeque* deque);
+
+/// @brief Empties the deque but keeps its capacity for reuse.
+void token_deque_clear(TokenDeque* deque);
+
+/// @brief Moves every token out of the list into a new deque, leaving the list empty.
+/// @note The deque inherits the list's ownership (heap or arena).
+TokenDeque* token_deque_from_list(TokenList* list);
+
+// --- Token Deque Operations ---
+
+bool token_deque_is_empty(const TokenDeque* deque);
+
+/// @note The deque takes ownership of the token; on failure ownership stays with the caller.
+bool token_deque_push_back(TokenDeque* deque, Token* token);
+bool token_deque_push_front(TokenDeque* deque, Token* token);
+
+/// @note Ownership moves to the caller (heap deques) or stays with the arena.
+Token* token_deque_pop_front(TokenDeque* deque);
+Token* token_deque_pop_back(TokenDeque* deque);
+
+/// @warning The returned token is owned by the deque. Do not free or modify.
+const Token* token_deque_peek_front(const TokenDeque* deque);
+const Token* token_deque_peek_back(const TokenDeque* deque);
+const Token* token_deque_peek_index(const TokenDeque* deque, size_t index); // From the front
+
+void token_deque_dump(const TokenDeque* deque);
+
+#endif // LEXER_TOKEN_DEQUE_H
@@ -8,6 +8,9 @@
  *     - If you pop it, you own it.
  *     - If you push it, you clone it.
  *     - If you free it, you kill it.
+ *     - If you move it (push_move / pop_move), the pointer changes hands without a clone.
+ *     - Arena-backed lists borrow: push stores the pointer, pop hands it back, and the arena
+ *       reclaims every token on reset.
  * @ref https://www.gingerbill.org/article/2020/06/21/the-ownership-semantics-flaw/
  */
 
@@ -26,21 +29,44 @@ typedef struct TokenList {
     size_t count;
     size_t capacity;
     Token** tokens;
+    Arena* arena; // Token storage (NULL if the list owns heap tokens)
 } TokenList;
 
 // --- Token List Operations ---
 
 TokenList* token_list_create(void);
+
+/// @brief Creates a list with room for `capacity` tokens before the first reallocation.
+TokenList* token_list_create_with_capacity(size_t capacity);
+TokenList* token_list_create_arena(Arena* arena);
 void token_list_free(TokenList* list);
 
+/// @brief Empties the list but keeps its capacity for reuse.
+void token_list_clear(TokenList* list);
+
+/// @brief Grows the list to hold at least `capacity` tokens; never shrinks.
+bool token_list_reserve(TokenList* list, size_t capacity);
+
 bool token_list_is_empty(const TokenList* list);
 bool token_list_is_full(const TokenList* list);
 
 /// @warning The token is cloned into the list and is owned by the list.
+/// @note Arena-backed lists store the pointer as-is; the token must outlive the arena reset.
 bool token_list_push(TokenList* list, const Token* token);
 
+/// @brief Transfers ownership of the token to the list; no clone is made.
+/// @note On failure the caller still owns the token.
+bool token_list_push_move(TokenList* list, Token* token);
+
 /// @warning The token is removed and freed from the list. A copy of the token is returned.
+/// @note Arena-backed lists return the stored pointer, which remains owned by the arena.
 Token* token_list_pop(TokenList* list);
+
+/// @brief Removes the last token and hands its pointer to the caller, who then owns it (heap
+///        lists) or borrows it from the arena; no clone is made.
+Token* token_list_pop_move(TokenList* list);
+/// @note Negative indices count from the end. Later tokens shift down, so this is O(n) away from
+///       the tail; use a TokenDeque to consume from the front.
 Token* token_list_pop_index(TokenList* list, int64_t index);
 
 /// @warning The returned token is owned by the list. Do not free or modify.
@@ -7,7 +7,61 @@
 #define LEXER_TOKENIZER_H
 
 #include "lexer/token_list.h"
+#include "lexer/token_array.h"
+#include "error.h"
+
+// --- Lexer ---
+
+/// @brief Pull-based lexer over a length-bounded source (NUL also terminates).
+typedef struct Lexer {
+    const char* source;
+    size_t length;
+    size_t offset; // Next byte to scan
+    Arena* arena; // Token storage (NULL for heap tokens)
+    bool view; // Borrow lexemes from the source instead of copying them
+    ShuntError error; // Why the last scan failed (code is SHUNT_STATUS_OK otherwise)
+} Lexer;
+
+void lexer_init(Lexer* lexer, const char* source, size_t length, Arena* arena, bool view);
+
+/// @brief Scans the next lexeme without building a token.
+/// @return false on an unknown character (recorded in lexer->error). At end of input, size is 0.
+bool lexer_scan(Lexer* lexer, TokenType* type, size_t* offset, size_t* size);
+
+/// @brief Builds the next token. At end of input, returns true with *token set to NULL.
+/// @note Heap tokens (NULL arena) are owned by the caller.
+/// @note Failures are recorded in lexer->error.
+bool lexer_next(Lexer* lexer, Token** token);
+
+// --- Capacity Hints ---
+
+/// @brief Expected token count for a source of `length` bytes, used to size lists upfront.
+/// @note Assumes about two bytes per token (a lexeme and a separator); dense input such as "1+2"
+///       needs at most one more doubling, since no token is shorter than a byte.
+static inline size_t tokenizer_capacity_hint(size_t length) {
+    return length / 2 + 1;
+}
+
+// --- Tokenizer ---
 
 TokenList* tokenizer(const char* expression);
 
+/// @brief General form of the list tokenizers below, reporting why tokenizing failed.
+/// @param arena Token storage (NULL for heap tokens owned by the list).
+/// @param view Borrow lexemes from the expression, which must then outlive the list.
+/// @param error Receives the failure (may be NULL). Columns are byte offsets.
+TokenList* tokenizer_checked(
+    const char* expression, size_t length, Arena* arena, bool view, ShuntError* error
+);
+
+/// @note Tokens are allocated from the arena; free the list, then reset the arena.
+TokenList* tokenizer_arena(const char* expression, Arena* arena);
+
+/// @note Tokens reference the expression by pointer and size; no lexeme is copied.
+/// @warning The expression must outlive the list. A NULL arena yields heap tokens.
+TokenList* tokenizer_view(const char* expression, Arena* arena);
+
+/// @note Packed tokens with offsets into the expression, which must outlive the array.
+TokenArray* tokenizer_array(const char* expression);
+
 #endif // LEXER_TOKENIZER_H
@@ -0,0 +1,50 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file include/parallel.h
+ * @brief Spreads the conversion of one very large expression across a worker pool.
+ * @note Tokenizing splits the text into byte chunks that are lexed concurrently. A token only
+ *       depends on the text from its start on, so a chunk that starts inside a token (say, in the
+ *       middle of a long number) falls back in step at its first token that also starts a token
+ *       of the whole text; a short sequential re-lex across each seam finds that point.
+ * @note Parentheses fence the shunting-yard: a group's postfix is exactly the postfix of its
+ *       interior. Large groups are therefore converted concurrently, each replaced in the
+ *       enclosing expression by a placeholder operand, and stitched back in where the placeholder
+ *       lands. Operators outside every large group (e.g. a long flat sum) stay sequential.
+ */
+
+#ifndef SHUNT_PARALLEL_H
+#define SHUNT_PARALLEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "lexer/token_array.h"
+#include "error.h"
+
+#define SHUNT_PARALLEL_CHUNK 65536 // Fewest bytes worth lexing on their own
+#define SHUNT_PARALLEL_GRAIN 4096 // Fewest interior tokens worth converting on their own
+
+// --- Parallel Conversion ---
+
+/// @brief tokenizer_array() across `threads` workers (0 uses every online core).
+/// @param error Receives the failure (may be NULL). Columns are byte offsets.
+/// @note Produces the same array as tokenizer_array(). Inputs under two chunks are lexed inline.
+TokenArray* shunt_parallel_tokenize(
+    const char* expression, size_t length, size_t threads, ShuntError* error
+);
+
+/// @brief shunt_yard_array() across `threads` workers (0 uses every online core).
+/// @return The same postfix as shunt_yard_array(), or NULL where it would fail.
+TokenArray* shunt_parallel_yard(const TokenArray* infix, size_t threads);
+
+/// @brief Tokenizes and converts in parallel.
+/// @param error Receives the failure (may be NULL): a lexing error, UNBALANCED at the offending
+///        parenthesis, or MEMORY. The result still needs shunt_is_valid_postfix_array().
+/// @warning The postfix borrows the expression, which must outlive it.
+TokenArray* shunt_parallel_expression(
+    const char* expression, size_t length, size_t threads, ShuntError* error
+);
+
+#endif // SHUNT_PARALLEL_H
@@ -9,13 +9,126 @@
 #define SHUNTING_YARD_H
 
 #include "lexer/token_list.h"
+#include "lexer/token_array.h"
+#include "error.h"
+#include "tree.h"
+
+// --- Limits ---
+
+/// @brief Bounds on untrusted input, enforced by the fused converters as they go, so a hostile
+///        expression is turned away before it costs more than the bounds allow. Zero disables one.
+/// @note The token bound also caps the lists reserved upfront, and the lists never outgrow it, so
+///       a bounded parse holds memory proportional to max_tokens, not to the source length.
+typedef struct ShuntLimits {
+    size_t max_bytes; // Source length, checked before anything is allocated
+    size_t max_tokens; // Infix tokens lexed
+    size_t max_depth; // Operator stack height: open '(' plus operators awaiting their operands
+} ShuntLimits;
+
+// --- Conversion ---
 
 TokenList* shunt_yard(const TokenList* infix);
 
+/// @note The postfix list borrows the infix tokens (no clones); both must outlive the arena reset.
+TokenList* shunt_yard_arena(const TokenList* infix, Arena* arena);
+
+/// @brief shunt_yard() / shunt_yard_arena() reporting why conversion failed.
+/// @param arena Token storage (NULL clones tokens onto the heap).
+/// @param error Receives the failure (may be NULL). Columns are infix token indices.
+TokenList* shunt_yard_checked(const TokenList* infix, Arena* arena, ShuntError* error);
+
+/// @brief Converts and validates in the same pass, replacing shunt_is_valid_infix() before and
+///        shunt_postfix_depth() after the conversion.
+/// @param max_depth Receives the peak evaluation stack depth of the result (may be NULL).
+/// @return NULL (with SHUNT_STATUS_MALFORMED) unless the expression reduces to a single value.
+TokenList* shunt_yard_validated(
+    const TokenList* infix, Arena* arena, size_t* max_depth, ShuntError* error
+);
+
+/// @brief shunt_yard_validated() that also builds the expression tree in the same pass.
+/// @param tree Cleared, then filled with one node per postfix token (see tree.h). Nodes borrow the
+///        postfix tokens, so the tree is only valid while the returned list is.
+/// @return NULL (with the tree left empty) if the expression is malformed.
+TokenList* shunt_yard_tree(
+    const TokenList* infix, Arena* arena, ShuntTree* tree, ShuntError* error
+);
+
+/// @brief Lexes and converts in a single pass: tokens flow from the lexer straight into the
+///        shunting-yard state machine, so no infix list is ever built.
+/// @note Lexemes are views into the expression, which must outlive the result. With an arena the
+///       tokens live in the arena; with NULL the returned list owns heap tokens.
+TokenList* shunt_expression(const char* expression, size_t length, Arena* arena);
+
+/// @brief shunt_expression() reporting why conversion failed.
+/// @param error Receives the failure (may be NULL). Columns are byte offsets into the expression.
+TokenList* shunt_expression_checked(
+    const char* expression, size_t length, Arena* arena, ShuntError* error
+);
+
+/// @brief shunt_expression() with the fused validation of shunt_yard_validated().
+TokenList* shunt_expression_validated(
+    const char* expression, size_t length, Arena* arena, size_t* max_depth, ShuntError* error
+);
+
+/// @brief shunt_expression_validated() that also builds the tree (see shunt_yard_tree()).
+TokenList* shunt_expression_tree(
+    const char* expression, size_t length, Arena* arena, ShuntTree* tree, ShuntError* error
+);
+
+/// @brief shunt_expression_validated() under limits (may be NULL for none).
+/// @return NULL with SHUNT_STATUS_LIMIT as soon as the input exceeds one: the column and token are
+///         the first ones past the bound (the bound itself, with no token, for max_bytes).
+TokenList* shunt_expression_bounded(
+    const char* expression,
+    size_t length,
+    Arena* arena,
+    const ShuntLimits* limits,
+    ShuntError* error
+);
+
+/// @note The postfix array borrows the infix source; tags carry the resolved unary/binary role.
+TokenArray* shunt_yard_array(const TokenArray* infix);
+
+/// @brief shunt_yard_array() reporting why conversion failed.
+/// @param error Receives the failure (may be NULL): UNBALANCED at the offending parenthesis, or
+///        MEMORY. Columns are byte offsets into the source.
+TokenArray* shunt_yard_array_checked(const TokenArray* infix, ShuntError* error);
+
+// --- Reusable Context ---
+
+/// @brief Owns the operator stack, output queue and token arena across many parses. Each parse
+///        resets them in place, so capacity settles at the high-water mark and steady-state parsing
+///        performs no allocation.
+typedef struct ShuntContext {
+    Arena* arena; // Token storage
+    TokenList* postfix; // Output queue (borrows arena tokens)
+    TokenList* operators; // Operator stack (borrows arena tokens)
+    ShuntError error; // Outcome of the last parse (columns are byte offsets)
+    bool validate; // Validate while parsing (see shunt_yard_validated()); off by default
+    size_t depth; // Peak evaluation stack depth of the last successful parse
+    ShuntLimits limits; // Applied to every parse (see shunt_expression_bounded()); none by default
+} ShuntContext;
+
+ShuntContext* shunt_context_create(void);
+void shunt_context_reset(ShuntContext* context);
+void shunt_context_free(ShuntContext* context);
+
+/// @return The postfix list owned by the context, valid until the next parse or reset.
+/// @warning Lexemes are views, so the expression must outlive the result as well.
+const TokenList* shunt_context_parse(ShuntContext* context, const char* expression, size_t length);
+
+/// @brief Like shunt_context_parse() but leaves the arena alone, so tokens from earlier parses stay
+///        valid until the next reset. Only the list itself is reused.
+const TokenList* shunt_context_append(ShuntContext* context, const char* expression, size_t length);
+
 // --- Utilities ---
 
 bool shunt_is_valid_infix(const TokenList* infix);
 bool shunt_is_valid_postfix(const TokenList* postfix);
+bool shunt_postfix_depth(const TokenList* postfix, size_t* max_depth); // Valid + peak stack depth
 void shunt_debug(const TokenList* postfix);
 
+bool shunt_is_valid_postfix_array(const TokenArray* postfix);
+void shunt_debug_array(const TokenArray* postfix);
+
 #endif // SHUNTING_YARD_H
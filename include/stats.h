@@ -0,0 +1,147 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file include/stats.h
+ * @brief Optional hot-path counters and begin/end trace hooks.
+ * @note Built only with SHUNT_STATS defined (CMake: -DSHUNT_ENABLE_STATS=ON). Otherwise every
+ *       SHUNT_STAT_* and SHUNT_TRACE_* macro expands to nothing and the snapshot API reports zeros,
+ *       so callers compile unchanged either way.
+ * @note Each thread bumps its own counter block with relaxed loads and stores: no locked
+ *       instructions and no shared cache lines on the hot path. Blocks are registered on first use
+ *       and folded into a global total when their thread exits, so a snapshot sums every thread.
+ */
+
+#ifndef SHUNT_STATS_H
+#define SHUNT_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(SHUNT_STATS)
+    #include <stdatomic.h>
+#endif
+
+// --- Counters ---
+
+typedef enum ShuntStat {
+    SHUNT_STAT_TOKENS_LEXED,
+    SHUNT_STAT_LIST_GROWS, // token_list_push() reallocations
+    SHUNT_STAT_TOKEN_CLONES, // token_clone() heap copies
+    SHUNT_STAT_PRECEDENT_CALLS, // shunt_precedent(): one per binary operator
+    SHUNT_STAT_PRECEDENT_POPS, // Operators it moved to the output
+    SHUNT_STAT_GROUP_CALLS, // shunt_group(): one per ')'
+    SHUNT_STAT_GROUP_POPS, // Operators it moved to the output
+    SHUNT_STAT_TOKENIZE_CALLS,
+    SHUNT_STAT_TOKENIZE_NS, // Wall time inside the tokenizers
+    SHUNT_STAT_SHUNT_CALLS,
+    SHUNT_STAT_SHUNT_NS, // Wall time inside shunt_yard*() and shunt_expression*()
+    SHUNT_STAT_COUNT,
+} ShuntStat;
+
+typedef struct ShuntStats {
+    uint64_t values[SHUNT_STAT_COUNT];
+} ShuntStats;
+
+const char* shunt_stat_to_string(ShuntStat stat);
+
+/// @brief Sums the counters of every thread, live or exited.
+/// @return false (with all counters zero) when stats are compiled out.
+/// @note Live threads keep counting while the snapshot is taken, so totals are a moment's view.
+bool shunt_stats_snapshot(ShuntStats* stats);
+
+/// @brief Like shunt_stats_snapshot(), but only the calling thread's counters.
+bool shunt_stats_snapshot_local(ShuntStats* stats);
+
+/// @brief Zeroes every counter.
+/// @warning An increment racing the reset on another thread may survive it.
+void shunt_stats_reset(void);
+
+// --- Trace Hooks ---
+
+typedef enum ShuntTraceEvent {
+    SHUNT_TRACE_TOKENIZE, // tokenizer*(): input bytes, then tokens produced
+    SHUNT_TRACE_SHUNT, // shunt_yard*(): input tokens (bytes when fused), then output tokens
+} ShuntTraceEvent;
+
+/// @param end false when the call begins, true when it returns.
+/// @param size What the call consumes at the beginning and produces at the end (0 on failure).
+typedef void (*ShuntTraceHook)(void* user, ShuntTraceEvent event, bool end, size_t size);
+
+typedef struct ShuntTracer {
+    ShuntTraceHook hook;
+    void* user;
+} ShuntTracer;
+
+/// @brief Installs the tracer for every thread (NULL removes it).
+/// @warning The tracer is borrowed and must stay valid until replaced; the hook runs on whichever
+///          thread makes the call, so it must be thread-safe.
+void shunt_trace_set(const ShuntTracer* tracer);
+
+// --- Instrumentation ---
+
+#if defined(SHUNT_STATS)
+
+typedef struct ShuntStatsLocal {
+    _Atomic uint64_t values[SHUNT_STAT_COUNT];
+    struct ShuntStatsLocal* next; // Registry of live threads (guarded by the registry lock)
+} ShuntStatsLocal;
+
+extern _Thread_local ShuntStatsLocal* shunt_stats_local;
+extern _Atomic(const ShuntTracer*) shunt_tracer;
+
+/// @brief Registers a counter block for the calling thread.
+/// @return A shared overflow block if registration runs out of memory, never NULL.
+ShuntStatsLocal* shunt_stats_attach(void);
+
+uint64_t shunt_stats_clock(void);
+
+/// @note The owning thread is the only writer, so a relaxed read-modify-write needs no lock.
+static inline void shunt_stat_add(ShuntStat stat, uint64_t amount) {
+    ShuntStatsLocal* local = shunt_stats_local ? shunt_stats_local : shunt_stats_attach();
+    _Atomic uint64_t* value = &local->values[stat];
+    atomic_store_explicit(
+        value, atomic_load_explicit(value, memory_order_relaxed) + amount, memory_order_relaxed
+    );
+}
+
+static inline uint64_t shunt_trace_begin(ShuntTraceEvent event, size_t size) {
+    const ShuntTracer* tracer = atomic_load_explicit(&shunt_tracer, memory_order_acquire);
+    if (tracer && tracer->hook) {
+        tracer->hook(tracer->user, event, false, size);
+    }
+    return shunt_stats_clock();
+}
+
+static inline void shunt_trace_end(ShuntTraceEvent event, size_t size, uint64_t start) {
+    const uint64_t elapsed = shunt_stats_clock() - start;
+    if (event == SHUNT_TRACE_TOKENIZE) {
+        shunt_stat_add(SHUNT_STAT_TOKENIZE_CALLS, 1);
+        shunt_stat_add(SHUNT_STAT_TOKENIZE_NS, elapsed);
+    } else {
+        shunt_stat_add(SHUNT_STAT_SHUNT_CALLS, 1);
+        shunt_stat_add(SHUNT_STAT_SHUNT_NS, elapsed);
+    }
+
+    const ShuntTracer* tracer = atomic_load_explicit(&shunt_tracer, memory_order_acquire);
+    if (tracer && tracer->hook) {
+        tracer->hook(tracer->user, event, true, size);
+    }
+}
+
+    #define SHUNT_STAT_ADD(stat, amount) shunt_stat_add((stat), (uint64_t) (amount))
+    #define SHUNT_TRACE_BEGIN(event, size) \
+        const uint64_t shunt_trace_start_ = shunt_trace_begin((event), (size))
+    #define SHUNT_TRACE_END(event, size) shunt_trace_end((event), (size), shunt_trace_start_)
+
+#else
+
+    #define SHUNT_STAT_ADD(stat, amount) ((void) 0)
+    #define SHUNT_TRACE_BEGIN(event, size) ((void) 0)
+    #define SHUNT_TRACE_END(event, size) ((void) 0)
+
+#endif // SHUNT_STATS
+
+#define SHUNT_STAT_INC(stat) SHUNT_STAT_ADD(stat, 1)
+
+#endif // SHUNT_STATS_H
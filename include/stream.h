@@ -0,0 +1,72 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file include/stream.h
+ * @brief Streams newline-delimited expressions from a file descriptor or an in-memory region
+ *        (e.g. an mmap'd file) and converts each line to postfix.
+ * @note Lines are parsed in place: lexemes are views into the stream buffer or region, so no line
+ *       is ever copied into its own C string. A descriptor is read in large chunks; a line that
+ *       straddles a chunk boundary is carried to the front of the buffer before the next read.
+ */
+
+#ifndef SHUNT_STREAM_H
+#define SHUNT_STREAM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "lexer/token_list.h"
+#include "parser.h"
+
+#define SHUNT_STREAM_CHUNK (1u << 20) // Default bytes per read()
+
+// --- Line ---
+
+typedef struct ShuntStreamLine {
+    const char* text; // Start of the line (not NUL-terminated, newline and '\r' stripped)
+    size_t length;
+    size_t number; // 1-based line number in the input
+    ShuntError error; // code is SHUNT_STATUS_OK on success; columns are offsets into text
+    size_t depth; // Peak evaluation stack depth (0 unless SHUNT_STATUS_OK)
+    const TokenList* postfix; // Owned by the stream (NULL unless SHUNT_STATUS_OK)
+} ShuntStreamLine;
+
+// --- Stream ---
+
+typedef struct ShuntStream {
+    int fd; // Source descriptor (-1 for a memory region)
+    char* buffer; // Chunk buffer (descriptor streams only)
+    size_t capacity;
+    const char* data; // Buffer or region being scanned
+    size_t start; // First unconsumed byte of data
+    size_t end; // One past the last valid byte of data
+    size_t line; // Number of the last line returned
+    bool eof; // No more bytes will arrive
+    bool error; // read() failed
+    ShuntContext* context;
+} ShuntStream;
+
+// --- Stream Lifecycle ---
+
+/// @param chunk_size Bytes per read(); 0 selects SHUNT_STREAM_CHUNK. Grows for longer lines.
+/// @note The stream does not close the descriptor.
+ShuntStream* shunt_stream_open_fd(int fd, size_t chunk_size);
+
+/// @note The region is borrowed and must outlive the stream.
+ShuntStream* shunt_stream_open_memory(const char* data, size_t length);
+
+void shunt_stream_free(ShuntStream* stream);
+
+// --- Streaming ---
+
+/// @brief Reads and converts the next non-blank line (lines of only whitespace are skipped).
+/// @return false at end of input or on a read error (see shunt_stream_failed()). A line that
+///         fails to convert still returns true and reports the failure through line->error.
+/// @warning line->text and line->postfix are only valid until the next call.
+bool shunt_stream_next(ShuntStream* stream, ShuntStreamLine* line);
+
+/// @return true if the stream stopped because read() failed rather than at end of input.
+bool shunt_stream_failed(const ShuntStream* stream);
+
+#endif // SHUNT_STREAM_H
@@ -0,0 +1,75 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file include/tree.h
+ * @brief Flat expression tree: one contiguous node array linked by indices, not pointers.
+ * @note Node i is built from postfix token i, so every operand precedes its operator and the root
+ *       is always the last node. A forward sweep is therefore a bottom-up traversal, which is what
+ *       rewriting passes (constant folding, strength reduction, ...) need, with no recursion.
+ * @note shunt_yard_tree() and shunt_expression_tree() in parser.h build the tree in the same pass
+ *       as the postfix; shunt_tree_from_postfix() builds one from any existing postfix list.
+ */
+
+#ifndef SHUNT_TREE_H
+#define SHUNT_TREE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "lexer/token.h"
+#include "lexer/token_list.h"
+
+#define SHUNT_NODE_NONE UINT32_MAX // No operand (leaf, or the missing side of a unary operator)
+
+// --- Node ---
+
+typedef struct ShuntNode {
+    const Token* token; // Postfix token the node was built from (borrowed)
+    uint32_t left; // First operand; the only one of a unary operator
+    uint32_t right; // Second operand of a binary operator
+} ShuntNode;
+
+// --- Tree ---
+
+typedef struct ShuntTree {
+    size_t count;
+    size_t capacity;
+    ShuntNode* nodes; // In postfix order
+    uint32_t* pending; // Nodes still waiting for their operator (scratch, same capacity)
+    size_t pending_count;
+} ShuntTree;
+
+// --- Tree Lifecycle ---
+
+ShuntTree* shunt_tree_create(void);
+void shunt_tree_free(ShuntTree* tree);
+
+/// @brief Empties the tree but keeps its capacity for reuse.
+void shunt_tree_clear(ShuntTree* tree);
+
+/// @brief Grows the tree to hold at least `capacity` nodes; never shrinks.
+bool shunt_tree_reserve(ShuntTree* tree, size_t capacity);
+
+// --- Tree Building ---
+
+/// @brief Adds the node for the next postfix token, linking the pending nodes it consumes.
+/// @return false if the token lacks operands or memory runs out; the tree is left unchanged.
+/// @warning The token is borrowed and must outlive the tree (or its next clear).
+bool shunt_tree_append(ShuntTree* tree, const Token* token);
+
+/// @brief Rebuilds the tree from a postfix list.
+/// @return false (leaving the tree empty) unless the postfix reduces to a single value.
+bool shunt_tree_from_postfix(ShuntTree* tree, const TokenList* postfix);
+
+// --- Tree Queries ---
+
+/// @return The root index, or SHUNT_NODE_NONE unless the nodes form exactly one expression.
+uint32_t shunt_tree_root(const ShuntTree* tree);
+
+/// @return 0 for operands, 1 for unary and 2 for binary operators.
+size_t shunt_tree_arity(const ShuntNode* node);
+
+void shunt_tree_dump(const ShuntTree* tree);
+
+#endif // SHUNT_TREE_H
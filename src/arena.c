@@ -0,0 +1,163 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file src/arena.c
+ * @brief Bump allocator for expression-scoped memory.
+ * @note Allocations are never freed individually. Everything drawn from an arena is released at
+ *       once by arena_reset() (keeps the blocks for reuse) or arena_free() (returns them).
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+static ArenaBlock* arena_block_create(size_t capacity) {
+    ArenaBlock* block = malloc(sizeof(ArenaBlock) + capacity);
+    if (!block) {
+        return NULL;
+    }
+
+    block->next = NULL;
+    block->capacity = capacity;
+    block->offset = 0;
+    return block;
+}
+
+static void* arena_block_take(ArenaBlock* block, size_t size, size_t alignment) {
+    uintptr_t base = (uintptr_t) block->data;
+    uintptr_t start = (base + block->offset + (alignment - 1)) & ~(uintptr_t) (alignment - 1);
+    size_t offset = (size_t) (start - base);
+
+    if (offset > block->capacity || size > block->capacity - offset) {
+        return NULL;
+    }
+
+    block->offset = offset + size;
+    return block->data + offset;
+}
+
+// --- Arena Lifecycle ---
+
+Arena* arena_create(size_t block_size) {
+    Arena* arena = malloc(sizeof(Arena));
+    if (!arena) {
+        return NULL;
+    }
+
+    arena->block_size = block_size > 0 ? block_size : ARENA_BLOCK_SIZE;
+    arena->head = arena_block_create(arena->block_size);
+    if (!arena->head) {
+        free(arena);
+        return NULL;
+    }
+
+    arena->current = arena->head;
+    return arena;
+}
+
+void arena_reset(Arena* arena) {
+    if (!arena) {
+        return;
+    }
+
+    for (ArenaBlock* block = arena->head; block; block = block->next) {
+        block->offset = 0;
+    }
+    arena->current = arena->head;
+}
+
+void arena_free(Arena* arena) {
+    if (arena) {
+        ArenaBlock* block = arena->head;
+        while (block) {
+            ArenaBlock* next = block->next;
+            free(block);
+            block = next;
+        }
+        free(arena);
+    }
+}
+
+// --- Arena Allocation ---
+
+void* arena_alloc(Arena* arena, size_t size) {
+    return arena_alloc_aligned(arena, size, ARENA_ALIGNMENT);
+}
+
+void* arena_alloc_aligned(Arena* arena, size_t size, size_t alignment) {
+    if (!arena || size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        return NULL;
+    }
+
+    // Walk forward through blocks retained by a previous reset before growing the chain
+    while (true) {
+        void* ptr = arena_block_take(arena->current, size, alignment);
+        if (ptr) {
+            return ptr;
+        }
+
+        ArenaBlock* next = arena->current->next;
+        if (!next) {
+            break;
+        }
+        next->offset = 0;
+        arena->current = next;
+    }
+
+    size_t capacity = arena->block_size;
+    if (capacity < size + alignment) {
+        capacity = size + alignment;
+    }
+
+    ArenaBlock* block = arena_block_create(capacity);
+    if (!block) {
+        return NULL;
+    }
+
+    arena->current->next = block;
+    arena->current = block;
+    return arena_block_take(block, size, alignment);
+}
+
+char* arena_strndup(Arena* arena, const char* src, size_t size) {
+    if (!src) {
+        return NULL;
+    }
+
+    char* dst = arena_alloc_aligned(arena, size + 1, 1);
+    if (!dst) {
+        return NULL;
+    }
+
+    memcpy(dst, src, size);
+    dst[size] = '\0';
+    return dst;
+}
+
+// --- Arena Introspection ---
+
+size_t arena_used(const Arena* arena) {
+    size_t used = 0;
+    if (arena) {
+        for (const ArenaBlock* block = arena->head; block; block = block->next) {
+            used += block->offset;
+            if (block == arena->current) {
+                break;
+            }
+        }
+    }
+    return used;
+}
+
+size_t arena_capacity(const Arena* arena) {
+    size_t capacity = 0;
+    if (arena) {
+        for (const ArenaBlock* block = arena->head; block; block = block->next) {
+            capacity += block->capacity;
+        }
+    }
+    return capacity;
+}
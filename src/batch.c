@@ -0,0 +1,201 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file src/batch.c
+ * @brief Converts large sets of independent infix expressions to postfix across a worker pool.
+ * @note Workers claim fixed-size chunks of the input from a shared atomic cursor, so uneven
+ *       expression lengths balance out without any locking. Each worker parses through its own
+ *       ShuntContext, whose arena holds every token it produced until the batch is freed.
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "lexer/token_list.h"
+#include "parser.h"
+#include "batch.h"
+
+// --- Worker ---
+
+typedef struct ShuntBatchJob {
+    const char* const* expressions;
+    const size_t* lengths;
+    ShuntBatch* batch;
+    atomic_size_t next; // First unclaimed expression
+    atomic_size_t failures;
+} ShuntBatchJob;
+
+typedef struct ShuntBatchWorker {
+    ShuntBatchJob* job;
+    ShuntContext* context;
+} ShuntBatchWorker;
+
+/// @brief Parses and validates one expression in a single pass, then copies its postfix pointers
+///        into the worker arena, which is never reset during the batch, so the tokens outlive the
+///        next parse.
+static bool shunt_batch_convert(
+    ShuntContext* context, const char* expression, size_t length, ShuntBatchResult* result
+) {
+    const TokenList* postfix = shunt_context_append(context, expression, length);
+    if (!postfix) {
+        result->error = context->error;
+        return false;
+    }
+    result->depth = context->depth;
+
+    Token** tokens = arena_alloc(context->arena, sizeof(Token*) * postfix->count);
+    if (!tokens) {
+        shunt_error_set(&result->error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, 0, 0);
+        return false;
+    }
+
+    memcpy(tokens, postfix->tokens, sizeof(Token*) * postfix->count);
+    result->postfix = tokens;
+    result->count = postfix->count;
+    return true;
+}
+
+static void* shunt_batch_work(void* arg) {
+    ShuntBatchWorker* worker = arg;
+    ShuntBatchJob* job = worker->job;
+    ShuntBatch* batch = job->batch;
+    size_t failures = 0;
+
+    while (true) {
+        size_t start
+            = atomic_fetch_add_explicit(&job->next, SHUNT_BATCH_CHUNK, memory_order_relaxed);
+        if (start >= batch->count) {
+            break;
+        }
+
+        size_t end = batch->count - start < SHUNT_BATCH_CHUNK ? batch->count
+                                                              : start + SHUNT_BATCH_CHUNK;
+        for (size_t i = start; i < end; i++) {
+            const char* expression = job->expressions[i];
+            ShuntBatchResult* result = &batch->results[i];
+            *result = (ShuntBatchResult) {.arena = worker->context->arena};
+
+            bool ok = false;
+            if (!expression) {
+                shunt_error_set(&result->error, SHUNT_STATUS_EMPTY, TOKEN_TYPE_NONE, 0, 0);
+            } else {
+                size_t length = job->lengths ? job->lengths[i] : strlen(expression);
+                ok = shunt_batch_convert(worker->context, expression, length, result);
+            }
+
+            if (!ok) {
+                result->depth = 0;
+                failures++;
+            }
+        }
+    }
+
+    atomic_fetch_add_explicit(&job->failures, failures, memory_order_relaxed);
+    return NULL;
+}
+
+// --- Batch Lifecycle ---
+
+static size_t shunt_batch_thread_count(size_t threads, size_t count) {
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (size_t) online : 1;
+    }
+
+    // No point starting workers that would never claim a chunk
+    size_t chunks = (count + SHUNT_BATCH_CHUNK - 1) / SHUNT_BATCH_CHUNK;
+    if (threads > chunks) {
+        threads = chunks;
+    }
+    return threads > 0 ? threads : 1;
+}
+
+ShuntBatch* shunt_batch(
+    const char* const* expressions, const size_t* lengths, size_t count, size_t threads
+) {
+    if (!expressions && count > 0) {
+        return NULL;
+    }
+
+    ShuntBatch* batch = calloc(1, sizeof(ShuntBatch));
+    if (!batch) {
+        return NULL;
+    }
+
+    batch->count = count;
+    batch->worker_count = shunt_batch_thread_count(threads, count);
+    batch->results = calloc(count > 0 ? count : 1, sizeof(ShuntBatchResult));
+    batch->workers = calloc(batch->worker_count, sizeof(ShuntContext*));
+    ShuntBatchWorker* workers = calloc(batch->worker_count, sizeof(ShuntBatchWorker));
+    pthread_t* handles = calloc(batch->worker_count, sizeof(pthread_t));
+    if (!batch->results || !batch->workers || !workers || !handles) {
+        free(handles);
+        free(workers);
+        shunt_batch_free(batch);
+        return NULL;
+    }
+
+    ShuntBatchJob job = {.expressions = expressions, .lengths = lengths, .batch = batch};
+    atomic_init(&job.next, 0);
+    atomic_init(&job.failures, 0);
+
+    for (size_t i = 0; i < batch->worker_count; i++) {
+        batch->workers[i] = shunt_context_create();
+        if (!batch->workers[i]) {
+            free(handles);
+            free(workers);
+            shunt_batch_free(batch);
+            return NULL;
+        }
+        batch->workers[i]->validate = true;
+        workers[i] = (ShuntBatchWorker) {.job = &job, .context = batch->workers[i]};
+    }
+
+    // The calling thread is worker 0; any worker that fails to start leaves its share to the rest
+    size_t started = 0;
+    for (size_t i = 1; i < batch->worker_count; i++) {
+        if (pthread_create(&handles[started], NULL, shunt_batch_work, &workers[i]) == 0) {
+            started++;
+        }
+    }
+
+    shunt_batch_work(&workers[0]);
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(handles[i], NULL);
+    }
+
+    batch->failures = atomic_load(&job.failures);
+    free(handles);
+    free(workers);
+    return batch;
+}
+
+void shunt_batch_free(ShuntBatch* batch) {
+    if (batch) {
+        for (size_t i = 0; batch->workers && i < batch->worker_count; i++) {
+            shunt_context_free(batch->workers[i]);
+        }
+        free(batch->workers);
+        free(batch->results);
+        free(batch);
+    }
+}
+
+// --- Results ---
+
+TokenList shunt_batch_list(const ShuntBatch* batch, size_t index) {
+    if (!batch || index >= batch->count || batch->results[index].error.code != SHUNT_STATUS_OK) {
+        return (TokenList) {0};
+    }
+
+    const ShuntBatchResult* result = &batch->results[index];
+    return (TokenList) {
+        .count = result->count,
+        .capacity = result->count,
+        .tokens = result->postfix,
+        .arena = result->arena,
+    };
+}
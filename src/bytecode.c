@@ -0,0 +1,889 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file src/bytecode.c
+ * @brief Compiles postfix TokenLists into a flat instruction array and executes it.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+
+#include "lexer/token.h"
+#include "parser.h"
+#include "bytecode.h"
+#include "jit.h"
+
+static bool bytecode_run_integer(const Bytecode* program, int64_t* stack, int64_t* result);
+static bool bytecode_run_float(
+    const Bytecode* program, const double* variables, double* stack, double* result
+);
+
+// --- Program Lifecycle ---
+
+static bool bytecode_emit(Bytecode* program, Instruction instruction) {
+    if (program->count >= program->capacity) {
+        size_t capacity = program->capacity ? program->capacity * 2 : 8;
+        Instruction* code = realloc(program->code, sizeof(Instruction) * capacity);
+        if (!code) {
+            return false;
+        }
+        program->code = code;
+        program->capacity = capacity;
+    }
+
+    program->code[program->count++] = instruction;
+    return true;
+}
+
+static bool bytecode_opcode(const Token* token, OpCode* opcode) {
+    if (token_is_role_unary(token)) {
+        if (token_is_type_minus(token)) {
+            *opcode = OP_NEG;
+            return true;
+        }
+        return false; // unary plus is elided by the caller
+    }
+
+    switch (token->type) {
+        case TOKEN_TYPE_PLUS:
+            *opcode = OP_ADD;
+            return true;
+        case TOKEN_TYPE_MINUS:
+            *opcode = OP_SUB;
+            return true;
+        case TOKEN_TYPE_STAR:
+            *opcode = OP_MUL;
+            return true;
+        case TOKEN_TYPE_SLASH:
+            *opcode = OP_DIV;
+            return true;
+        case TOKEN_TYPE_MOD:
+            *opcode = OP_MOD;
+            return true;
+        case TOKEN_TYPE_POWER:
+            *opcode = OP_POW;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool bytecode_bind(Bytecode* program, const Token* token, uint64_t* slot) {
+    for (size_t i = 0; i < program->variable_count; i++) {
+        const char* name = program->variables[i];
+        if (strlen(name) == token->size && memcmp(name, token->lexeme, token->size) == 0) {
+            *slot = i;
+            return true;
+        }
+    }
+
+    char** variables = realloc(program->variables, sizeof(char*) * (program->variable_count + 1));
+    if (!variables) {
+        return false;
+    }
+    program->variables = variables;
+
+    char* name = strndup(token->lexeme, token->size);
+    if (!name) {
+        return false;
+    }
+
+    *slot = program->variable_count;
+    program->variables[program->variable_count++] = name;
+    return true;
+}
+
+/// @brief Integer arithmetic applies unless a float literal or a variable is present.
+static bool bytecode_is_integral(const TokenList* postfix) {
+    for (size_t i = 0; i < postfix->count; i++) {
+        const Token* token = postfix->tokens[i];
+        if (token_is_type_float(token) || token_is_type_identifier(token)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool bytecode_decode(const Token* token, bool integral, Instruction* instruction) {
+    return integral ? token_to_integer(token, &instruction->operand.integer)
+                    : token_to_float(token, &instruction->operand.real);
+}
+
+Bytecode* bytecode_compile(const TokenList* postfix) {
+    size_t depth = 0;
+    if (!shunt_postfix_depth(postfix, &depth)) {
+        return NULL;
+    }
+
+    Bytecode* program = malloc(sizeof(Bytecode));
+    if (!program) {
+        return NULL;
+    }
+
+    program->count = 0;
+    program->capacity = 0;
+    program->code = NULL;
+    program->depth = depth;
+    program->integral = bytecode_is_integral(postfix);
+    program->variable_count = 0;
+    program->variables = NULL;
+    program->borrowed = false;
+    program->jit_threshold = BYTECODE_JIT_THRESHOLD;
+    atomic_init(&program->jit_uses, 0);
+    atomic_init(&program->jit, NULL);
+
+    for (size_t i = 0; i < postfix->count; i++) {
+        const Token* token = postfix->tokens[i];
+        Instruction instruction = {0};
+
+        if (token_is_number(token)) {
+            instruction.opcode = OP_PUSH;
+            if (!bytecode_decode(token, program->integral, &instruction)) {
+                goto error;
+            }
+        } else if (token_is_type_identifier(token)) {
+            instruction.opcode = OP_LOAD;
+            if (!bytecode_bind(program, token, &instruction.operand.slot)) {
+                goto error;
+            }
+        } else if (token_is_role_unary(token) && token_is_type_plus(token)) {
+            continue; // identity
+        } else {
+            OpCode opcode;
+            if (!bytecode_opcode(token, &opcode)) {
+                goto error;
+            }
+            instruction.opcode = (uint8_t) opcode;
+        }
+
+        if (!bytecode_emit(program, instruction)) {
+            goto error;
+        }
+    }
+
+    bytecode_fold(program);
+    return program;
+
+error:
+    bytecode_free(program);
+    return NULL;
+}
+
+const Token* bytecode_range_fault(const TokenList* postfix) {
+    if (!postfix) {
+        return NULL;
+    }
+
+    const bool integral = bytecode_is_integral(postfix);
+    for (size_t i = 0; i < postfix->count; i++) {
+        const Token* token = postfix->tokens[i];
+        Instruction instruction;
+        if (token_is_number(token) && !bytecode_decode(token, integral, &instruction)) {
+            return token;
+        }
+    }
+    return NULL;
+}
+
+void bytecode_free(Bytecode* program) {
+    if (program) {
+        bytecode_jit_free(atomic_load_explicit(&program->jit, memory_order_acquire));
+        for (size_t i = 0; !program->borrowed && i < program->variable_count; i++) {
+            free(program->variables[i]);
+        }
+        free(program->variables); // a loaded program still owns the slot table
+        if (!program->borrowed) {
+            free(program->code);
+        }
+        free(program);
+    }
+}
+
+int64_t bytecode_variable_slot(const Bytecode* program, const char* name) {
+    if (!program || !name) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < program->variable_count; i++) {
+        if (strcmp(program->variables[i], name) == 0) {
+            return (int64_t) i;
+        }
+    }
+    return -1;
+}
+
+// --- Execution ---
+
+static bool bytecode_run_integer(const Bytecode* program, int64_t* stack, int64_t* result) {
+    const Instruction* ip = program->code;
+    const Instruction* end = ip + program->count;
+    int64_t* sp = stack; // Points one past the top
+
+    for (; ip < end; ip++) {
+        switch ((OpCode) ip->opcode) {
+            case OP_PUSH:
+                *sp++ = ip->operand.integer;
+                break;
+            case OP_NEG:
+                sp[-1] = (int64_t) (0 - (uint64_t) sp[-1]);
+                break;
+            case OP_ADD:
+                sp--;
+                sp[-1] = (int64_t) ((uint64_t) sp[-1] + (uint64_t) sp[0]);
+                break;
+            case OP_SUB:
+                sp--;
+                sp[-1] = (int64_t) ((uint64_t) sp[-1] - (uint64_t) sp[0]);
+                break;
+            case OP_MUL:
+                sp--;
+                sp[-1] = (int64_t) ((uint64_t) sp[-1] * (uint64_t) sp[0]);
+                break;
+            case OP_DIV:
+                sp--;
+                if (sp[0] == 0 || (sp[-1] == INT64_MIN && sp[0] == -1)) {
+                    return false;
+                }
+                sp[-1] /= sp[0];
+                break;
+            case OP_MOD:
+                sp--;
+                if (sp[0] == 0 || (sp[-1] == INT64_MIN && sp[0] == -1)) {
+                    return false;
+                }
+                sp[-1] %= sp[0];
+                break;
+            case OP_POW:
+                sp--;
+                if (!rpn_integer_power(sp[-1], sp[0], &sp[-1])) {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+
+    *result = stack[0];
+    return true;
+}
+
+static bool bytecode_run_float(
+    const Bytecode* program, const double* variables, double* stack, double* result
+) {
+    const Instruction* ip = program->code;
+    const Instruction* end = ip + program->count;
+    double* sp = stack; // Points one past the top
+
+    for (; ip < end; ip++) {
+        switch ((OpCode) ip->opcode) {
+            case OP_PUSH:
+                *sp++ = ip->operand.real;
+                break;
+            case OP_LOAD:
+                *sp++ = variables[ip->operand.slot];
+                break;
+            case OP_NEG:
+                sp[-1] = -sp[-1];
+                break;
+            case OP_ADD:
+                sp--;
+                sp[-1] += sp[0];
+                break;
+            case OP_SUB:
+                sp--;
+                sp[-1] -= sp[0];
+                break;
+            case OP_MUL:
+                sp--;
+                sp[-1] *= sp[0];
+                break;
+            case OP_DIV:
+                sp--;
+                sp[-1] /= sp[0];
+                break;
+            case OP_MOD:
+                sp--;
+                sp[-1] = fmod(sp[-1], sp[0]);
+                break;
+            case OP_POW:
+                sp--;
+                sp[-1] = pow(sp[-1], sp[0]);
+                break;
+            default:
+                return false;
+        }
+    }
+
+    *result = stack[0];
+    return true;
+}
+
+/// @brief Runs native code if the program has it, counting executions toward compiling it.
+/// @return false if the interpreter must run instead.
+static bool bytecode_execute_native(
+    const Bytecode* program, const double* variables, RpnValue* result
+) {
+    // The counters and native code are caches, not program state, so a const program updates them
+    Bytecode* hot = (Bytecode*) program;
+
+    const BytecodeJit* jit = atomic_load_explicit(&hot->jit, memory_order_acquire);
+    if (jit) {
+        result->type = TOKEN_TYPE_FLOAT;
+        result->real = jit->function(variables);
+        return true;
+    }
+
+    // Past the threshold (compiled elsewhere or unsupported) the counter is only read, so hot
+    // programs stop bouncing its cache line between threads
+    const size_t threshold = program->jit_threshold;
+    if (program->integral || threshold == 0
+        || atomic_load_explicit(&hot->jit_uses, memory_order_relaxed) >= threshold) {
+        return false;
+    }
+
+    // Exactly one caller sees the threshold reached, so the program is compiled at most once
+    if (atomic_fetch_add_explicit(&hot->jit_uses, 1, memory_order_relaxed) + 1 == threshold) {
+        atomic_store_explicit(&hot->jit, bytecode_jit_compile(program), memory_order_release);
+    }
+    return false;
+}
+
+bool bytecode_execute(const Bytecode* program, const double* variables, RpnValue* result) {
+    if (!program || !result || program->count == 0) {
+        return false;
+    }
+
+    if (program->variable_count > 0 && !variables) {
+        return false;
+    }
+
+    if (bytecode_execute_native(program, variables, result)) {
+        return true;
+    }
+
+    bool ok = false;
+    if (program->integral) {
+        int64_t local[RPN_STACK_SIZE];
+        int64_t* stack = program->depth <= RPN_STACK_SIZE
+                             ? local
+                             : malloc(sizeof(int64_t) * program->depth);
+        if (!stack) {
+            return false;
+        }
+
+        result->type = TOKEN_TYPE_INTEGER;
+        ok = bytecode_run_integer(program, stack, &result->integer);
+        if (stack != local) {
+            free(stack);
+        }
+    } else {
+        double local[RPN_STACK_SIZE];
+        double* stack = program->depth <= RPN_STACK_SIZE ? local
+                                                         : malloc(sizeof(double) * program->depth);
+        if (!stack) {
+            return false;
+        }
+
+        result->type = TOKEN_TYPE_FLOAT;
+        ok = bytecode_run_float(program, variables, stack, &result->real);
+        if (stack != local) {
+            free(stack);
+        }
+    }
+
+    return ok;
+}
+
+// --- Optimization ---
+
+static bool bytecode_is_binary(uint8_t opcode) {
+    return opcode >= OP_ADD && opcode <= OP_POW;
+}
+
+static size_t bytecode_peak_depth(const Bytecode* program) {
+    size_t depth = 0;
+    size_t peak = 0;
+
+    for (size_t i = 0; i < program->count; i++) {
+        const uint8_t opcode = program->code[i].opcode;
+        if (opcode == OP_PUSH || opcode == OP_LOAD) {
+            if (++depth > peak) {
+                peak = depth;
+            }
+        } else if (bytecode_is_binary(opcode)) {
+            depth--;
+        }
+    }
+
+    return peak;
+}
+
+/// @brief Evaluates a constant operator by running its operands through the interpreter, so folded
+///        results match runtime semantics exactly.
+static bool bytecode_fold_operator(
+    const Bytecode* program, const Instruction* operands, size_t arity, Instruction* folded
+) {
+    Instruction code[3];
+    for (size_t i = 0; i < arity; i++) {
+        code[i] = operands[i];
+    }
+    code[arity] = operands[arity];
+
+    const Bytecode constant = {
+        .count = arity + 1,
+        .capacity = arity + 1,
+        .code = code,
+        .depth = arity,
+        .integral = program->integral,
+    };
+
+    folded->opcode = OP_PUSH;
+    if (program->integral) {
+        int64_t stack[2];
+        return bytecode_run_integer(&constant, stack, &folded->operand.integer);
+    }
+
+    double stack[2];
+    return bytecode_run_float(&constant, NULL, stack, &folded->operand.real);
+}
+
+size_t bytecode_fold(Bytecode* program) {
+    if (!program || !program->code || program->borrowed) {
+        return 0;
+    }
+
+    // Native code was built from the old instructions
+    bytecode_jit_free(atomic_exchange_explicit(&program->jit, NULL, memory_order_acq_rel));
+    atomic_store_explicit(&program->jit_uses, 0, memory_order_relaxed);
+
+    // Rewrite in place: a constant subtree is always a run of PUSHes directly before its operator
+    size_t folds = 0;
+    size_t w = 0;
+    for (size_t r = 0; r < program->count; r++) {
+        program->code[w++] = program->code[r];
+
+        const uint8_t opcode = program->code[w - 1].opcode;
+        size_t arity = 0;
+        if (opcode == OP_NEG) {
+            arity = 1;
+        } else if (bytecode_is_binary(opcode)) {
+            arity = 2;
+        } else {
+            continue;
+        }
+
+        if (w <= arity) {
+            continue;
+        }
+
+        Instruction* operands = &program->code[w - 1 - arity];
+        bool constant = true;
+        for (size_t i = 0; i < arity; i++) {
+            constant = constant && operands[i].opcode == OP_PUSH;
+        }
+
+        // Integer faults (division by zero) are left in place to fail at runtime
+        Instruction folded = {0};
+        if (constant && bytecode_fold_operator(program, operands, arity, &folded)) {
+            w -= arity;
+            program->code[w - 1] = folded;
+            folds++;
+        }
+    }
+
+    program->count = w;
+    program->depth = bytecode_peak_depth(program);
+    return folds;
+}
+
+// --- Batch Execution ---
+
+// Kernels run over one column block. Operands never alias the accumulator, so the loops are
+// restrict-qualified and left for the compiler to vectorize.
+
+static void batch_fill(double* restrict acc, double value, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        acc[i] = value;
+    }
+}
+
+static void batch_neg(double* restrict acc, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        acc[i] = -acc[i];
+    }
+}
+
+static void batch_add(double* restrict acc, const double* restrict rhs, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        acc[i] += rhs[i];
+    }
+}
+
+static void batch_sub(double* restrict acc, const double* restrict rhs, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        acc[i] -= rhs[i];
+    }
+}
+
+static void batch_mul(double* restrict acc, const double* restrict rhs, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        acc[i] *= rhs[i];
+    }
+}
+
+static void batch_div(double* restrict acc, const double* restrict rhs, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        acc[i] /= rhs[i];
+    }
+}
+
+static void batch_mod(double* restrict acc, const double* restrict rhs, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        acc[i] = fmod(acc[i], rhs[i]);
+    }
+}
+
+static void batch_pow(double* restrict acc, const double* restrict rhs, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        acc[i] = pow(acc[i], rhs[i]);
+    }
+}
+
+/// @brief Makes stack slot k writable, copying a borrowed input column into its scratch block.
+static double* batch_own(const double** slots, double* scratch, size_t k, size_t n) {
+    double* block = scratch + k * BYTECODE_BATCH_ROWS;
+    if (slots[k] != block) {
+        memcpy(block, slots[k], sizeof(double) * n);
+        slots[k] = block;
+    }
+    return block;
+}
+
+static bool bytecode_run_batch(
+    const Bytecode* program,
+    const double* const* columns,
+    size_t base,
+    size_t n,
+    const double** slots,
+    double* scratch,
+    double* out
+) {
+    size_t top = 0; // Stack slots in use; slot k is either scratch block k or a borrowed column
+
+    for (size_t ip = 0; ip < program->count; ip++) {
+        const Instruction* instruction = &program->code[ip];
+
+        switch ((OpCode) instruction->opcode) {
+            case OP_PUSH: {
+                double* block = scratch + top * BYTECODE_BATCH_ROWS;
+                batch_fill(block, instruction->operand.real, n);
+                slots[top++] = block;
+                break;
+            }
+            case OP_LOAD:
+                slots[top++] = columns[instruction->operand.slot] + base;
+                break;
+            case OP_NEG:
+                batch_neg(batch_own(slots, scratch, top - 1, n), n);
+                break;
+            case OP_ADD:
+                top--;
+                batch_add(batch_own(slots, scratch, top - 1, n), slots[top], n);
+                break;
+            case OP_SUB:
+                top--;
+                batch_sub(batch_own(slots, scratch, top - 1, n), slots[top], n);
+                break;
+            case OP_MUL:
+                top--;
+                batch_mul(batch_own(slots, scratch, top - 1, n), slots[top], n);
+                break;
+            case OP_DIV:
+                top--;
+                batch_div(batch_own(slots, scratch, top - 1, n), slots[top], n);
+                break;
+            case OP_MOD:
+                top--;
+                batch_mod(batch_own(slots, scratch, top - 1, n), slots[top], n);
+                break;
+            case OP_POW:
+                top--;
+                batch_pow(batch_own(slots, scratch, top - 1, n), slots[top], n);
+                break;
+            default:
+                return false;
+        }
+    }
+
+    memcpy(out + base, slots[0], sizeof(double) * n);
+    return true;
+}
+
+bool bytecode_execute_batch(
+    const Bytecode* program, const double* const* columns, size_t rows, double* out
+) {
+    if (!program || !out || program->count == 0) {
+        return false;
+    }
+
+    if (program->variable_count > 0 && !columns) {
+        return false;
+    }
+
+    // Integral programs have no variables, so every row yields the same value
+    if (program->integral) {
+        RpnValue value;
+        if (!bytecode_execute(program, NULL, &value)) {
+            return false;
+        }
+        batch_fill(out, (double) value.integer, rows);
+        return true;
+    }
+
+    const double** slots = malloc(sizeof(double*) * program->depth);
+    double* scratch = malloc(sizeof(double) * program->depth * BYTECODE_BATCH_ROWS);
+    bool ok = slots && scratch;
+
+    for (size_t base = 0; ok && base < rows; base += BYTECODE_BATCH_ROWS) {
+        size_t n = rows - base < BYTECODE_BATCH_ROWS ? rows - base : BYTECODE_BATCH_ROWS;
+        ok = bytecode_run_batch(program, columns, base, n, slots, scratch, out);
+    }
+
+    free(slots);
+    free(scratch);
+    return ok;
+}
+
+// --- Serialization ---
+
+_Static_assert(sizeof(BytecodeImage) == 32, "BytecodeImage must have no padding");
+_Static_assert(
+    sizeof(Instruction) == 16 && offsetof(Instruction, operand) == 8,
+    "Instruction must match the 16-byte image record"
+);
+
+static size_t bytecode_align(size_t size) {
+    return (size + 7) & ~(size_t) 7;
+}
+
+static size_t bytecode_names_size(const Bytecode* program) {
+    size_t size = 0;
+    for (size_t i = 0; i < program->variable_count; i++) {
+        size += strlen(program->variables[i]) + 1;
+    }
+    return bytecode_align(size);
+}
+
+size_t bytecode_image_size(const Bytecode* program) {
+    if (!program || program->count > UINT32_MAX || program->depth > UINT32_MAX
+        || program->variable_count > UINT32_MAX) {
+        return 0;
+    }
+
+    return sizeof(BytecodeImage) + sizeof(Instruction) * program->count
+           + bytecode_names_size(program);
+}
+
+size_t bytecode_serialize(const Bytecode* program, void* buffer, size_t capacity) {
+    const size_t size = bytecode_image_size(program);
+    if (size == 0 || !buffer || capacity < size) {
+        return 0;
+    }
+
+    uint8_t* out = buffer;
+    const BytecodeImage header = {
+        .magic = {'S', 'Y', 'B', 'C'},
+        .version = BYTECODE_IMAGE_VERSION,
+        .flags = program->integral ? BYTECODE_IMAGE_INTEGRAL : 0,
+        .order = BYTECODE_IMAGE_ORDER,
+        .count = (uint32_t) program->count,
+        .depth = (uint32_t) program->depth,
+        .variable_count = (uint32_t) program->variable_count,
+        .size = size,
+    };
+    memset(out, 0, size); // padding bytes are part of the format
+    memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+
+    // Field by field, so the padding after the opcode stays zero
+    for (size_t i = 0; i < program->count; i++) {
+        out[0] = program->code[i].opcode;
+        memcpy(out + offsetof(Instruction, operand), &program->code[i].operand, 8);
+        out += sizeof(Instruction);
+    }
+
+    for (size_t i = 0; i < program->variable_count; i++) {
+        const size_t length = strlen(program->variables[i]) + 1;
+        memcpy(out, program->variables[i], length);
+        out += length;
+    }
+    return size;
+}
+
+/// @brief Replays the stack effect of every instruction, so a loaded program can never read past
+///        its stack or a variable array: the checks compile() and shunt_postfix_depth() did.
+static bool bytecode_verify(const Instruction* code, const BytecodeImage* header) {
+    const bool integral = header->flags & BYTECODE_IMAGE_INTEGRAL;
+    size_t depth = 0;
+
+    for (size_t i = 0; i < header->count; i++) {
+        const Instruction* instruction = &code[i];
+        switch ((OpCode) instruction->opcode) {
+            case OP_LOAD:
+                if (integral || instruction->operand.slot >= header->variable_count) {
+                    return false;
+                }
+                // fallthrough
+            case OP_PUSH:
+                if (++depth > header->depth) {
+                    return false;
+                }
+                break;
+            case OP_NEG:
+                if (depth < 1) {
+                    return false;
+                }
+                break;
+            case OP_ADD:
+            case OP_SUB:
+            case OP_MUL:
+            case OP_DIV:
+            case OP_MOD:
+            case OP_POW:
+                if (depth < 2) {
+                    return false;
+                }
+                depth--;
+                break;
+            default:
+                return false;
+        }
+    }
+
+    return depth == 1;
+}
+
+Bytecode* bytecode_load(const void* image, size_t size, size_t* consumed) {
+    if (!image || size < sizeof(BytecodeImage) || (uintptr_t) image % 8 != 0) {
+        return NULL;
+    }
+
+    const BytecodeImage* header = image;
+    if (memcmp(header->magic, BYTECODE_IMAGE_MAGIC, sizeof(header->magic)) != 0
+        || header->version != BYTECODE_IMAGE_VERSION || header->order != BYTECODE_IMAGE_ORDER
+        || header->size > size || header->size < sizeof(BytecodeImage) || header->size % 8 != 0
+        || header->depth > header->count) {
+        return NULL;
+    }
+
+    const size_t code_size = sizeof(Instruction) * (size_t) header->count;
+    if (code_size > header->size - sizeof(BytecodeImage)) {
+        return NULL;
+    }
+
+    const uint8_t* base = image;
+    const Instruction* code = (const Instruction*) (base + sizeof(BytecodeImage));
+    const char* names = (const char*) code + code_size;
+    const char* end = (const char*) base + header->size;
+    // Every name takes at least its NUL, which bounds the slot table before it is allocated
+    if ((size_t) header->variable_count > (size_t) (end - names)
+        || !bytecode_verify(code, header)) {
+        return NULL;
+    }
+
+    Bytecode* program = calloc(1, sizeof(Bytecode));
+    char** variables = calloc(header->variable_count ? header->variable_count : 1, sizeof(char*));
+    if (!program || !variables) {
+        free(program);
+        free(variables);
+        return NULL;
+    }
+
+    // Slot names are NUL-terminated and must all lie inside the image
+    for (size_t i = 0; i < header->variable_count; i++) {
+        const char* nul = memchr(names, '\0', (size_t) (end - names));
+        if (!nul) {
+            free(variables);
+            free(program);
+            return NULL;
+        }
+        variables[i] = (char*) names;
+        names = nul + 1;
+    }
+
+    // The code is shared read-only; borrowed programs are never folded or written
+    program->code = (Instruction*) code;
+    program->count = header->count;
+    program->capacity = header->count;
+    program->depth = header->depth;
+    program->integral = header->flags & BYTECODE_IMAGE_INTEGRAL;
+    program->variable_count = header->variable_count;
+    program->variables = variables;
+    program->borrowed = true;
+    program->jit_threshold = BYTECODE_JIT_THRESHOLD;
+
+    if (consumed) {
+        *consumed = header->size;
+    }
+    return program;
+}
+
+static const char* bytecode_opcode_to_string(uint8_t opcode) {
+    switch ((OpCode) opcode) {
+        case OP_PUSH:
+            return "PUSH";
+        case OP_LOAD:
+            return "LOAD";
+        case OP_NEG:
+            return "NEG";
+        case OP_ADD:
+            return "ADD";
+        case OP_SUB:
+            return "SUB";
+        case OP_MUL:
+            return "MUL";
+        case OP_DIV:
+            return "DIV";
+        case OP_MOD:
+            return "MOD";
+        case OP_POW:
+            return "POW";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+void bytecode_dump(const Bytecode* program) {
+    if (!program) {
+        return;
+    }
+
+    printf(
+        "[Bytecode] count=%zu, depth=%zu, mode=%s, variables=%zu\n",
+        program->count,
+        program->depth,
+        program->integral ? "INTEGER" : "FLOAT",
+        program->variable_count
+    );
+
+    for (size_t i = 0; i < program->count; i++) {
+        const Instruction* instruction = &program->code[i];
+        if (instruction->opcode == OP_PUSH) {
+            if (program->integral) {
+                printf("[Bytecode] %04zu PUSH %lld\n", i, (long long) instruction->operand.integer);
+            } else {
+                printf("[Bytecode] %04zu PUSH %.17g\n", i, instruction->operand.real);
+            }
+        } else if (instruction->opcode == OP_LOAD) {
+            printf(
+                "[Bytecode] %04zu LOAD %s\n", i, program->variables[instruction->operand.slot]
+            );
+        } else {
+            printf("[Bytecode] %04zu %s\n", i, bytecode_opcode_to_string(instruction->opcode));
+        }
+    }
+}
@@ -0,0 +1,373 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file src/cache.c
+ * @brief Thread-safe cache of compiled expressions keyed by their normalized source text.
+ * @note One mutex guards the index and counters, and is only held for the lookup itself: misses
+ *       parse and compile outside the lock, so a slow expression never stalls hits on others.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "lexer/token.h"
+#include "lexer/token_list.h"
+#include "parser.h"
+#include "cache.h"
+
+#define SHUNT_CACHE_FNV_OFFSET 0xcbf29ce484222325ull
+#define SHUNT_CACHE_FNV_PRIME 0x100000001b3ull
+#define SHUNT_CACHE_KEY_STACK 256 // Keys up to this size are normalized on the stack
+
+// --- Normalization ---
+
+static bool shunt_cache_is_word(char c) {
+    const uint8_t class = token_char_class(c);
+    return class == TOKEN_CHAR_DIGIT || class == TOKEN_CHAR_IDENT || c == '.';
+}
+
+/// @brief True if dropping the whitespace before c could merge tokens of the key so far with it.
+/// @note Beyond adjacent words and "**", a sign can complete an exponent ("1e +5" is not 1e+5),
+///       and so can a digit after one ("1e+ 5").
+static bool shunt_cache_joins(const char* key, size_t size, char c) {
+    const char a = key[size - 1];
+    if ((shunt_cache_is_word(a) && shunt_cache_is_word(c)) || (a == '*' && c == '*')) {
+        return true;
+    }
+
+    const bool marker = a == 'e' || a == 'E';
+    const bool sign = a == '+' || a == '-';
+    if (marker && (c == '+' || c == '-')) {
+        return true;
+    }
+    return sign && token_char_class(c) == TOKEN_CHAR_DIGIT && size > 1
+           && (key[size - 2] == 'e' || key[size - 2] == 'E');
+}
+
+static uint64_t shunt_cache_mix(uint64_t hash, char c) {
+    return (hash ^ (unsigned char) c) * SHUNT_CACHE_FNV_PRIME;
+}
+
+/// @brief Copies the expression into key without insignificant whitespace, hashing as it goes.
+/// @return The key length, which never exceeds the expression length.
+static size_t shunt_cache_normalize(
+    const char* expression, size_t length, char* key, uint64_t* hash
+) {
+    uint64_t h = SHUNT_CACHE_FNV_OFFSET;
+    size_t size = 0;
+    bool space = false;
+
+    for (size_t i = 0; i < length && expression[i] != '\0'; i++) {
+        const char c = expression[i];
+        if (token_char_class(c) == TOKEN_CHAR_SPACE) {
+            space = true;
+            continue;
+        }
+
+        if (space && size > 0 && shunt_cache_joins(key, size, c)) {
+            key[size++] = ' ';
+            h = shunt_cache_mix(h, ' ');
+        }
+        space = false;
+        key[size++] = c;
+        h = shunt_cache_mix(h, c);
+    }
+
+    *hash = h;
+    return size;
+}
+
+// --- Entries ---
+
+static void shunt_cache_entry_free(ShuntCacheEntry* entry) {
+    if (entry) {
+        bytecode_free(entry->program);
+        free(entry->key);
+        free(entry);
+    }
+}
+
+/// @brief Parses and compiles the expression as given, so errors report its own columns.
+static ShuntCacheEntry* shunt_cache_entry_create(
+    const char* expression,
+    size_t length,
+    const char* key,
+    size_t size,
+    uint64_t hash,
+    ShuntError* error
+) {
+    TokenList* postfix = shunt_expression_validated(expression, length, NULL, NULL, error);
+    if (!postfix) {
+        return NULL;
+    }
+
+    Bytecode* program = bytecode_compile(postfix);
+    if (!program) {
+        // Validated postfix fails to compile on a literal that does not fit its type, or on memory
+        const Token* literal = bytecode_range_fault(postfix);
+        if (literal) {
+            const size_t column = (size_t) (literal->lexeme - expression); // lexemes are views
+            shunt_error_set(error, SHUNT_STATUS_RANGE, literal->type, column, literal->size);
+        } else {
+            shunt_error_set(error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, 0, 0);
+        }
+        token_list_free(postfix);
+        return NULL;
+    }
+    token_list_free(postfix);
+
+    ShuntCacheEntry* entry = calloc(1, sizeof(ShuntCacheEntry));
+    char* copy = malloc(size > 0 ? size : 1);
+    if (!entry || !copy) {
+        shunt_error_set(error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, 0, 0);
+        bytecode_free(program);
+        free(entry);
+        free(copy);
+        return NULL;
+    }
+
+    memcpy(copy, key, size);
+    entry->hash = hash;
+    entry->length = size;
+    entry->key = copy;
+    entry->program = program;
+    return entry;
+}
+
+// --- Index (caller holds the lock) ---
+
+static ShuntCacheEntry* shunt_cache_find(
+    const ShuntCache* cache, const char* key, size_t size, uint64_t hash
+) {
+    ShuntCacheEntry* entry = cache->buckets[hash & cache->mask];
+    for (; entry; entry = entry->next) {
+        if (entry->hash == hash && entry->length == size && memcmp(entry->key, key, size) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void shunt_cache_unlink(ShuntCache* cache, ShuntCacheEntry* entry) {
+    ShuntCacheEntry** link = &cache->buckets[entry->hash & cache->mask];
+    while (*link != entry) {
+        link = &(*link)->next;
+    }
+    *link = entry->next;
+    entry->next = NULL;
+    entry->cached = false;
+}
+
+/// @brief Drops an entry from the index; it is freed now, or by its last release if pinned.
+static void shunt_cache_retire(ShuntCache* cache, ShuntCacheEntry* entry) {
+    shunt_cache_unlink(cache, entry);
+    if (entry->pins == 0) {
+        shunt_cache_entry_free(entry);
+    }
+}
+
+/// @brief Sweeps the CLOCK hand to a victim, giving recently hit entries a second chance.
+/// @return The freed slot.
+static size_t shunt_cache_evict(ShuntCache* cache) {
+    while (true) {
+        const size_t slot = cache->hand;
+        ShuntCacheEntry* entry = cache->slots[slot];
+        cache->hand = (slot + 1) % cache->capacity;
+
+        if (entry->referenced) {
+            entry->referenced = false;
+            continue;
+        }
+
+        shunt_cache_retire(cache, entry);
+        cache->slots[slot] = NULL;
+        cache->count--;
+        cache->stats.evictions++;
+        return slot;
+    }
+}
+
+static void shunt_cache_insert(ShuntCache* cache, ShuntCacheEntry* entry) {
+    const size_t slot = cache->count < cache->capacity ? cache->count : shunt_cache_evict(cache);
+
+    ShuntCacheEntry** bucket = &cache->buckets[entry->hash & cache->mask];
+    entry->next = *bucket;
+    entry->cached = true;
+    *bucket = entry;
+
+    cache->slots[slot] = entry;
+    cache->count++;
+}
+
+// --- Cache Lifecycle ---
+
+ShuntCache* shunt_cache_create(size_t capacity) {
+    if (capacity == 0) {
+        capacity = SHUNT_CACHE_CAPACITY;
+    }
+
+    size_t buckets = 1;
+    while (buckets < capacity * 2) {
+        buckets *= 2;
+    }
+
+    ShuntCache* cache = calloc(1, sizeof(ShuntCache));
+    if (!cache) {
+        return NULL;
+    }
+
+    cache->capacity = capacity;
+    cache->mask = buckets - 1;
+    cache->stats.capacity = capacity;
+    cache->slots = calloc(capacity, sizeof(ShuntCacheEntry*));
+    cache->buckets = calloc(buckets, sizeof(ShuntCacheEntry*));
+    if (!cache->slots || !cache->buckets || pthread_mutex_init(&cache->lock, NULL) != 0) {
+        free(cache->slots);
+        free(cache->buckets);
+        free(cache);
+        return NULL;
+    }
+
+    return cache;
+}
+
+/// @note Caller holds the lock.
+static void shunt_cache_drop(ShuntCache* cache) {
+    // Slots fill from the front and an evicted slot is refilled at once, so the ring is dense
+    for (size_t i = 0; i < cache->count; i++) {
+        shunt_cache_retire(cache, cache->slots[i]);
+        cache->slots[i] = NULL;
+    }
+
+    cache->count = 0;
+    cache->hand = 0;
+    cache->stats = (ShuntCacheStats) {.capacity = cache->capacity};
+}
+
+void shunt_cache_clear(ShuntCache* cache) {
+    if (!cache) {
+        return;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    shunt_cache_drop(cache);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+void shunt_cache_free(ShuntCache* cache) {
+    if (cache) {
+        shunt_cache_drop(cache);
+        pthread_mutex_destroy(&cache->lock);
+        free(cache->slots);
+        free(cache->buckets);
+        free(cache);
+    }
+}
+
+// --- Lookup ---
+
+static const ShuntCacheEntry* shunt_cache_lookup(
+    ShuntCache* cache, const char* expression, size_t length, char* key, ShuntError* error
+) {
+    uint64_t hash = 0;
+    const size_t size = shunt_cache_normalize(expression, length, key, &hash);
+
+    pthread_mutex_lock(&cache->lock);
+    ShuntCacheEntry* entry = shunt_cache_find(cache, key, size, hash);
+    if (entry) {
+        entry->referenced = true;
+        entry->pins++;
+        cache->stats.hits++;
+        pthread_mutex_unlock(&cache->lock);
+        return entry;
+    }
+    cache->stats.misses++;
+    pthread_mutex_unlock(&cache->lock);
+
+    // Compile without the lock; another thread may insert the same key meanwhile
+    ShuntCacheEntry* created = shunt_cache_entry_create(expression, length, key, size, hash, error);
+    if (!created) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    entry = shunt_cache_find(cache, key, size, hash);
+    if (!entry) {
+        shunt_cache_insert(cache, created);
+        entry = created;
+        created = NULL;
+    }
+    entry->pins++;
+    pthread_mutex_unlock(&cache->lock);
+
+    shunt_cache_entry_free(created); // lost the race: keep the first copy
+    return entry;
+}
+
+const ShuntCacheEntry* shunt_cache_acquire(
+    ShuntCache* cache, const char* expression, size_t length, ShuntError* error
+) {
+    shunt_error_set(error, SHUNT_STATUS_OK, TOKEN_TYPE_NONE, 0, 0);
+    if (!cache || !expression) {
+        shunt_error_set(error, SHUNT_STATUS_EMPTY, TOKEN_TYPE_NONE, 0, 0);
+        return NULL;
+    }
+
+    // The key is never longer than the expression
+    char local[SHUNT_CACHE_KEY_STACK];
+    char* key = length <= sizeof(local) ? local : malloc(length);
+    if (!key) {
+        shunt_error_set(error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, 0, 0);
+        return NULL;
+    }
+
+    const ShuntCacheEntry* entry = shunt_cache_lookup(cache, expression, length, key, error);
+    if (key != local) {
+        free(key);
+    }
+    return entry;
+}
+
+void shunt_cache_release(ShuntCache* cache, const ShuntCacheEntry* entry) {
+    if (!cache || !entry) {
+        return;
+    }
+
+    ShuntCacheEntry* pinned = (ShuntCacheEntry*) entry;
+    pthread_mutex_lock(&cache->lock);
+    const bool retired = --pinned->pins == 0 && !pinned->cached;
+    pthread_mutex_unlock(&cache->lock);
+
+    if (retired) {
+        shunt_cache_entry_free(pinned);
+    }
+}
+
+bool shunt_cache_evaluate(
+    ShuntCache* cache,
+    const char* expression,
+    size_t length,
+    const double* variables,
+    RpnValue* result,
+    ShuntError* error
+) {
+    const ShuntCacheEntry* entry = shunt_cache_acquire(cache, expression, length, error);
+    if (!entry) {
+        return false;
+    }
+
+    const bool ok = bytecode_execute(entry->program, variables, result);
+    shunt_cache_release(cache, entry);
+    return ok;
+}
+
+void shunt_cache_stats(ShuntCache* cache, ShuntCacheStats* stats) {
+    if (!cache || !stats) {
+        return;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    *stats = cache->stats;
+    stats->count = cache->count;
+    pthread_mutex_unlock(&cache->lock);
+}
@@ -0,0 +1,401 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file src/editor.c
+ * @brief Incremental re-conversion of an expression that is edited in place (e.g. per keystroke).
+ * @note Lexing and shunting only touch the edited span and its enclosing group. Keeping the
+ *       arrays in step with the text (moving the tail and shifting its offsets) is a linear
+ *       memmove-and-add pass, which is far cheaper than re-converting the tail.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "lexer/tokenizer.h"
+#include "parser.h"
+#include "editor.h"
+
+// --- Token Spans ---
+
+static bool shunt_editor_emits(TokenTag tag) {
+    return token_tag_kind(tag) != TOKEN_KIND_GROUP; // operands and operators reach the postfix
+}
+
+static size_t shunt_editor_emitted(const TokenArray* array, size_t from, size_t to) {
+    size_t count = 0;
+    for (size_t i = from; i < to; i++) {
+        count += shunt_editor_emits(array->tags[i]);
+    }
+    return count;
+}
+
+/// @brief Index of the first token that ends at or after offset (it may merge with an edit there).
+static size_t shunt_editor_seek_end(const TokenArray* array, size_t offset) {
+    size_t low = 0;
+    size_t high = array->count;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if ((size_t) array->offsets[mid] + array->sizes[mid] < offset) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/// @brief Index of the first token that starts at or after offset.
+/// @note A token only depends on the text from its start on, so one that starts past an edit
+///       comes back unchanged once lexing reaches its (shifted) start again.
+static size_t shunt_editor_seek_start(const TokenArray* array, size_t offset) {
+    size_t low = 0;
+    size_t high = array->count;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (array->offsets[mid] < offset) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/// @brief Steps first back to a number the edit may extend with an exponent: "1e" + "5" lexes as
+///        one literal, though the 1 ends before the touched token. The gap must be "e" or "e+".
+/// @note Re-lexing from any earlier token start is correct, so a number that already has an
+///       exponent is not filtered out; it only costs re-lexing the two tokens after it.
+static size_t shunt_editor_seek_number(const ShuntEditor* editor, size_t first, size_t start) {
+    const TokenArray* infix = editor->infix;
+    for (size_t back = 1; back <= 2 && back <= first; back++) {
+        const size_t i = first - back;
+        if (token_tag_kind(infix->tags[i]) != TOKEN_KIND_LITERAL) {
+            continue;
+        }
+
+        const size_t end = (size_t) infix->offsets[i] + infix->sizes[i];
+        const char* gap = editor->source + end;
+        const size_t size = start - end; // tokens before first end before start
+        if (size >= 1 && size <= 2 && (gap[0] == 'e' || gap[0] == 'E')
+            && (size == 1 || gap[1] == '+' || gap[1] == '-')) {
+            return i;
+        }
+    }
+    return first;
+}
+
+/// @brief Replaces tokens [from, to) with the tokens of insert. Offsets are copied, not shifted.
+static bool shunt_editor_splice(
+    TokenArray* array, size_t from, size_t to, const TokenArray* insert
+) {
+    const size_t tail = array->count - to;
+    const size_t count = from + insert->count + tail;
+    if (!token_array_reserve(array, count)) {
+        return false;
+    }
+
+    const size_t at = from + insert->count;
+    memmove(array->tags + at, array->tags + to, sizeof(TokenTag) * tail);
+    memmove(array->offsets + at, array->offsets + to, sizeof(uint32_t) * tail);
+    memmove(array->sizes + at, array->sizes + to, sizeof(uint32_t) * tail);
+
+    memcpy(array->tags + from, insert->tags, sizeof(TokenTag) * insert->count);
+    memcpy(array->offsets + from, insert->offsets, sizeof(uint32_t) * insert->count);
+    memcpy(array->sizes + from, insert->sizes, sizeof(uint32_t) * insert->count);
+    array->count = count;
+    return true;
+}
+
+static uint32_t shunt_editor_shifted(uint32_t offset, int64_t delta) {
+    return (uint32_t) ((int64_t) offset + delta);
+}
+
+// --- Conversion ---
+
+/// @brief Re-converts for the error report only, through the validating parser.
+static void shunt_editor_diagnose(ShuntEditor* editor) {
+    TokenList* postfix = shunt_expression_validated(
+        editor->source, editor->length, NULL, NULL, &editor->error
+    );
+    if (postfix) {
+        // The validating parser is the stricter of the two, so this is not expected
+        token_list_free(postfix);
+        shunt_error_set(
+            &editor->error, SHUNT_STATUS_MALFORMED, TOKEN_TYPE_NONE, editor->length, 0
+        );
+    }
+}
+
+/// @brief Re-shunts the whole infix.
+static bool shunt_editor_rebuild(ShuntEditor* editor) {
+    token_array_free(editor->postfix);
+    editor->postfix = shunt_yard_array(editor->infix);
+    editor->reshunted = editor->infix->count;
+    editor->valid = editor->postfix && shunt_is_valid_postfix_array(editor->postfix);
+
+    if (!editor->valid) {
+        shunt_editor_diagnose(editor);
+        return false;
+    }
+    shunt_error_set(&editor->error, SHUNT_STATUS_OK, TOKEN_TYPE_NONE, 0, 0);
+    return true;
+}
+
+/// @brief Re-shunts only the innermost group around infix tokens [from, to) and splices its
+///        postfix over the group's old span.
+/// @param previous Postfix tokens emitted by the old tokens that [from, to) replaced.
+/// @param delta Size change of the text; tokens from `to` on are already shifted by it.
+/// @return false if the group cannot be re-shunted alone; the caller then rebuilds. On true,
+///         editor->valid tells whether the whole expression still converts.
+static bool shunt_editor_regroup(
+    ShuntEditor* editor, size_t from, size_t to, size_t previous, int64_t delta
+) {
+    const TokenArray* infix = editor->infix;
+
+    // Innermost '(' before the new tokens and ')' after them
+    size_t left = from;
+    for (size_t depth = 0; left > 0; left--) {
+        const TokenType type = token_tag_type(infix->tags[left - 1]);
+        if (type == TOKEN_TYPE_RIGHT_PAREN) {
+            depth++;
+        } else if (type == TOKEN_TYPE_LEFT_PAREN && depth-- == 0) {
+            break;
+        }
+    }
+    size_t right = to;
+    for (size_t depth = 0; right < infix->count; right++) {
+        const TokenType type = token_tag_type(infix->tags[right]);
+        if (type == TOKEN_TYPE_LEFT_PAREN) {
+            depth++;
+        } else if (type == TOKEN_TYPE_RIGHT_PAREN && depth-- == 0) {
+            break;
+        }
+    }
+    if (left == 0 || right == infix->count) {
+        return false; // top level: no enclosing group
+    }
+    left--; // the '(' itself
+
+    // The group's old postfix span: everything between its parentheses, in old coordinates
+    const uint32_t open = infix->offsets[left];
+    const uint32_t close = shunt_editor_shifted(infix->offsets[right], -delta);
+    const size_t span = shunt_editor_emitted(infix, left + 1, right)
+                        - shunt_editor_emitted(infix, from, to) + previous;
+
+    TokenArray* postfix = editor->postfix;
+    size_t start = 0;
+    while (start < postfix->count
+           && !(postfix->offsets[start] > open && postfix->offsets[start] < close)) {
+        start++;
+    }
+    if (span == 0 || start + span > postfix->count) {
+        return false;
+    }
+
+    // Borrow the group's interior as its own infix
+    TokenArray interior = {
+        .count = right - left - 1,
+        .capacity = right - left - 1,
+        .source = infix->source,
+        .tags = infix->tags + left + 1,
+        .offsets = infix->offsets + left + 1,
+        .sizes = infix->sizes + left + 1,
+    };
+    // Parentheses fence the conversion, so the group's postfix is exactly its span in the whole
+    TokenArray* group = shunt_yard_array(&interior);
+    if (!group || !shunt_editor_splice(postfix, start, start + span, group)) {
+        token_array_free(group);
+        return false;
+    }
+
+    // Tokens after the group move with the text; tokens before it and the new span stay put
+    for (size_t i = 0; i < postfix->count; i++) {
+        if ((i < start || i >= start + group->count) && postfix->offsets[i] > open) {
+            postfix->offsets[i] = shunt_editor_shifted(postfix->offsets[i], delta);
+        }
+    }
+
+    editor->reshunted = interior.count;
+    token_array_free(group);
+
+    // A stray operand in the group can balance a missing one elsewhere, so check the whole
+    editor->valid = shunt_is_valid_postfix_array(postfix);
+    if (!editor->valid) {
+        shunt_editor_diagnose(editor);
+    }
+    return true;
+}
+
+// --- Editor Lifecycle ---
+
+ShuntEditor* shunt_editor_create(const char* source, size_t length) {
+    if ((!source && length > 0) || length > UINT32_MAX) {
+        return NULL;
+    }
+
+    ShuntEditor* editor = calloc(1, sizeof(ShuntEditor));
+    if (!editor) {
+        return NULL;
+    }
+
+    editor->capacity = length + 1;
+    editor->source = malloc(editor->capacity);
+    editor->infix = token_array_create(NULL);
+    if (!editor->source || !editor->infix) {
+        shunt_editor_free(editor);
+        return NULL;
+    }
+    editor->source[0] = '\0';
+    editor->infix->source = editor->source;
+
+    // The initial conversion is an edit that inserts the whole text into an empty one
+    if (!shunt_editor_edit(editor, 0, 0, source, length) && editor->length != length) {
+        shunt_editor_free(editor); // out of memory
+        return NULL;
+    }
+    return editor;
+}
+
+void shunt_editor_free(ShuntEditor* editor) {
+    if (editor) {
+        token_array_free(editor->postfix);
+        token_array_free(editor->infix);
+        free(editor->source);
+        free(editor);
+    }
+}
+
+// --- Editing ---
+
+static bool shunt_editor_replace(
+    ShuntEditor* editor, size_t start, size_t end, const char* text, size_t length
+) {
+    const size_t size = editor->length - (end - start) + length;
+    if (size > UINT32_MAX) {
+        return false;
+    }
+
+    if (size + 1 > editor->capacity) {
+        size_t capacity = editor->capacity * 2 > size + 1 ? editor->capacity * 2 : size + 1;
+        char* source = realloc(editor->source, capacity);
+        if (!source) {
+            return false;
+        }
+        editor->source = source;
+        editor->capacity = capacity;
+    }
+
+    // Move the tail (and its NUL) behind the new text
+    memmove(editor->source + start + length, editor->source + end, editor->length - end + 1);
+    if (length > 0) {
+        memcpy(editor->source + start, text, length);
+    }
+    editor->length = size;
+
+    editor->infix->source = editor->source;
+    if (editor->postfix) {
+        editor->postfix->source = editor->source;
+    }
+    return true;
+}
+
+bool shunt_editor_edit(
+    ShuntEditor* editor, size_t start, size_t end, const char* text, size_t length
+) {
+    if (!editor || start > end || end > editor->length || (!text && length > 0)) {
+        return false;
+    }
+
+    TokenArray* infix = editor->infix;
+    const bool reuse = editor->lexed && editor->valid;
+
+    // Old tokens the edit may change: from the one it touches to the last one it reaches.
+    // Without a usable token list, every token is re-lexed.
+    size_t first = editor->lexed ? shunt_editor_seek_end(infix, start) : 0;
+    const size_t last = editor->lexed ? shunt_editor_seek_start(infix, end) : infix->count;
+    size_t from = 0;
+    if (editor->lexed) {
+        first = shunt_editor_seek_number(editor, first, start);
+        const bool touched = first < infix->count && infix->offsets[first] < start;
+        from = touched ? infix->offsets[first] : start;
+    }
+    const int64_t delta = (int64_t) length - (int64_t) (end - start);
+
+    if (!shunt_editor_replace(editor, start, end, text, length)) {
+        shunt_error_set(&editor->error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, start, 0);
+        return false;
+    }
+
+    TokenArray* fresh = token_array_create(editor->source);
+    if (!fresh) {
+        editor->lexed = editor->valid = false;
+        shunt_error_set(&editor->error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, start, 0);
+        return false;
+    }
+
+    // Re-lex until a new token starts exactly where an untouched old token now starts
+    Lexer lexer;
+    lexer_init(&lexer, editor->source, editor->length, NULL, true);
+    lexer.offset = from;
+    size_t resync = last;
+    while (true) {
+        TokenType type;
+        size_t offset;
+        size_t size;
+        if (!lexer_scan(&lexer, &type, &offset, &size)) {
+            token_array_free(fresh);
+            editor->lexed = editor->valid = false;
+            editor->error = lexer.error;
+            return false;
+        }
+
+        if (size == 0) {
+            resync = infix->count; // end of input: every old token from `first` on is replaced
+            break;
+        }
+
+        while (resync < infix->count
+               && shunt_editor_shifted(infix->offsets[resync], delta) < offset) {
+            resync++;
+        }
+        if (resync < infix->count
+            && shunt_editor_shifted(infix->offsets[resync], delta) == offset) {
+            break; // the rest of the old tokens are unchanged
+        }
+
+        if (!token_array_push(fresh, token_tag_lexed(type), (uint32_t) offset, (uint32_t) size)) {
+            token_array_free(fresh);
+            editor->lexed = editor->valid = false;
+            shunt_error_set(&editor->error, SHUNT_STATUS_MEMORY, type, offset, size);
+            return false;
+        }
+    }
+
+    // Adding or removing a parenthesis reshapes the groups, so only a full re-shunt will do
+    const size_t previous = shunt_editor_emitted(infix, first, resync);
+    const bool regroup = reuse && previous == resync - first
+                         && shunt_editor_emitted(fresh, 0, fresh->count) == fresh->count;
+    const size_t count = fresh->count;
+    const bool spliced = shunt_editor_splice(infix, first, resync, fresh);
+    token_array_free(fresh);
+    if (!spliced) {
+        editor->lexed = editor->valid = false;
+        shunt_error_set(&editor->error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, start, 0);
+        return false;
+    }
+    for (size_t i = first + count; i < infix->count; i++) {
+        infix->offsets[i] = shunt_editor_shifted(infix->offsets[i], delta);
+    }
+
+    editor->lexed = true;
+    editor->relexed = count;
+
+    if (regroup && shunt_editor_regroup(editor, first, first + count, previous, delta)) {
+        return editor->valid;
+    }
+    return shunt_editor_rebuild(editor);
+}
+
+const TokenArray* shunt_editor_postfix(const ShuntEditor* editor) {
+    return editor && editor->valid ? editor->postfix : NULL;
+}
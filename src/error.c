@@ -0,0 +1,31 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file src/error.c
+ * @brief Compact error reports shared by the lexer and parser.
+ */
+
+#include "error.h"
+
+const char* shunt_status_to_string(ShuntStatus status) {
+    switch (status) {
+        case SHUNT_STATUS_OK:
+            return "OK";
+        case SHUNT_STATUS_SYNTAX:
+            return "SYNTAX";
+        case SHUNT_STATUS_UNBALANCED:
+            return "UNBALANCED";
+        case SHUNT_STATUS_EMPTY:
+            return "EMPTY";
+        case SHUNT_STATUS_MALFORMED:
+            return "MALFORMED";
+        case SHUNT_STATUS_MEMORY:
+            return "MEMORY";
+        case SHUNT_STATUS_RANGE:
+            return "RANGE";
+        case SHUNT_STATUS_LIMIT:
+            return "LIMIT";
+        default:
+            return "UNKNOWN";
+    }
+}
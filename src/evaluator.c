@@ -0,0 +1,253 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file src/evaluator.c
+ * @brief Evaluator for postfix expressions produced by shunt_yard().
+ * @note Expressions made only of INTEGER literals are evaluated with int64 arithmetic; any FLOAT
+ *       literal promotes the whole expression to double arithmetic.
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include <stdio.h>
+
+#include "lexer/token.h"
+#include "lexer/token_list.h"
+#include "parser.h"
+#include "evaluator.h"
+
+// --- Arithmetic ---
+
+bool rpn_integer_power(int64_t base, int64_t exponent, int64_t* out) {
+    if (exponent < 0) {
+        if (base == 0) {
+            return false;
+        }
+        // |base| > 1 shrinks below one and truncates to zero; only +-1 survive
+        *out = base == 1 ? 1 : (base == -1 ? ((exponent & 1) ? -1 : 1) : 0);
+        return true;
+    }
+
+    uint64_t result = 1;
+    uint64_t factor = (uint64_t) base;
+    for (uint64_t bits = (uint64_t) exponent; bits; bits >>= 1) {
+        if (bits & 1) {
+            result *= factor;
+        }
+        factor *= factor;
+    }
+
+    *out = (int64_t) result;
+    return true;
+}
+
+// --- Integer Path ---
+
+/// @note Wraps on overflow (two's complement) rather than invoking undefined behavior.
+static bool rpn_integer_binary(const Token* op, int64_t a, int64_t b, int64_t* out) {
+    switch (op->type) {
+        case TOKEN_TYPE_PLUS:
+            *out = (int64_t) ((uint64_t) a + (uint64_t) b);
+            return true;
+        case TOKEN_TYPE_MINUS:
+            *out = (int64_t) ((uint64_t) a - (uint64_t) b);
+            return true;
+        case TOKEN_TYPE_STAR:
+            *out = (int64_t) ((uint64_t) a * (uint64_t) b);
+            return true;
+        case TOKEN_TYPE_SLASH:
+            if (b == 0 || (a == INT64_MIN && b == -1)) {
+                return false;
+            }
+            *out = a / b;
+            return true;
+        case TOKEN_TYPE_MOD:
+            if (b == 0 || (a == INT64_MIN && b == -1)) {
+                return false;
+            }
+            *out = a % b;
+            return true;
+        case TOKEN_TYPE_POWER:
+            return rpn_integer_power(a, b, out);
+        default:
+            return false;
+    }
+}
+
+static bool rpn_integer_unary(const Token* op, int64_t a, int64_t* out) {
+    switch (op->type) {
+        case TOKEN_TYPE_PLUS:
+            *out = a;
+            return true;
+        case TOKEN_TYPE_MINUS:
+            *out = (int64_t) (0 - (uint64_t) a);
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool rpn_evaluate_integer(const TokenList* postfix, int64_t* stack, int64_t* result) {
+    size_t top = 0;
+
+    for (size_t i = 0; i < postfix->count; i++) {
+        const Token* token = postfix->tokens[i];
+
+        if (token_is_number(token)) {
+            if (!token_to_integer(token, &stack[top++])) {
+                return false;
+            }
+        } else if (token_is_role_unary(token)) {
+            if (!rpn_integer_unary(token, stack[top - 1], &stack[top - 1])) {
+                return false;
+            }
+        } else {
+            top--;
+            if (!rpn_integer_binary(token, stack[top - 1], stack[top], &stack[top - 1])) {
+                return false;
+            }
+        }
+    }
+
+    *result = stack[0];
+    return true;
+}
+
+// --- Float Path ---
+
+static bool rpn_float_binary(const Token* op, double a, double b, double* out) {
+    switch (op->type) {
+        case TOKEN_TYPE_PLUS:
+            *out = a + b;
+            return true;
+        case TOKEN_TYPE_MINUS:
+            *out = a - b;
+            return true;
+        case TOKEN_TYPE_STAR:
+            *out = a * b;
+            return true;
+        case TOKEN_TYPE_SLASH:
+            *out = a / b;
+            return true;
+        case TOKEN_TYPE_MOD:
+            *out = fmod(a, b);
+            return true;
+        case TOKEN_TYPE_POWER:
+            *out = pow(a, b);
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool rpn_float_unary(const Token* op, double a, double* out) {
+    switch (op->type) {
+        case TOKEN_TYPE_PLUS:
+            *out = a;
+            return true;
+        case TOKEN_TYPE_MINUS:
+            *out = -a;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool rpn_evaluate_float(const TokenList* postfix, double* stack, double* result) {
+    size_t top = 0;
+
+    for (size_t i = 0; i < postfix->count; i++) {
+        const Token* token = postfix->tokens[i];
+
+        if (token_is_number(token)) {
+            if (!token_to_float(token, &stack[top++])) {
+                return false;
+            }
+        } else if (token_is_role_unary(token)) {
+            if (!rpn_float_unary(token, stack[top - 1], &stack[top - 1])) {
+                return false;
+            }
+        } else {
+            top--;
+            if (!rpn_float_binary(token, stack[top - 1], stack[top], &stack[top - 1])) {
+                return false;
+            }
+        }
+    }
+
+    *result = stack[0];
+    return true;
+}
+
+// --- Evaluation ---
+
+bool rpn_evaluate(const TokenList* postfix, RpnValue* result) {
+    if (!postfix || !postfix->tokens || !result) {
+        return false;
+    }
+
+    // Validation guarantees every pop below has an operand, so the loops skip bounds checks
+    size_t depth = 0;
+    if (!shunt_postfix_depth(postfix, &depth)) {
+        return false;
+    }
+
+    bool integral = true;
+    for (size_t i = 0; i < postfix->count; i++) {
+        if (token_is_type_identifier(postfix->tokens[i])) {
+            return false; // variables are bound by bytecode_execute()
+        }
+        if (token_is_type_float(postfix->tokens[i])) {
+            integral = false;
+        }
+    }
+
+    bool ok = false;
+    if (integral) {
+        int64_t local[RPN_STACK_SIZE];
+        int64_t* stack = depth <= RPN_STACK_SIZE ? local : malloc(sizeof(int64_t) * depth);
+        if (!stack) {
+            return false;
+        }
+
+        result->type = TOKEN_TYPE_INTEGER;
+        ok = rpn_evaluate_integer(postfix, stack, &result->integer);
+        if (stack != local) {
+            free(stack);
+        }
+    } else {
+        double local[RPN_STACK_SIZE];
+        double* stack = depth <= RPN_STACK_SIZE ? local : malloc(sizeof(double) * depth);
+        if (!stack) {
+            return false;
+        }
+
+        result->type = TOKEN_TYPE_FLOAT;
+        ok = rpn_evaluate_float(postfix, stack, &result->real);
+        if (stack != local) {
+            free(stack);
+        }
+    }
+
+    return ok;
+}
+
+double rpn_value_as_float(const RpnValue* value) {
+    if (!value) {
+        return NAN;
+    }
+
+    return value->type == TOKEN_TYPE_INTEGER ? (double) value->integer : value->real;
+}
+
+void rpn_value_dump(const RpnValue* value) {
+    if (!value) {
+        return;
+    }
+
+    if (value->type == TOKEN_TYPE_INTEGER) {
+        printf("[RpnValue] type=INTEGER, value=%lld\n", (long long) value->integer);
+    } else {
+        printf("[RpnValue] type=FLOAT, value=%.17g\n", value->real);
+    }
+}
@@ -0,0 +1,397 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file src/jit.c
+ * @brief Compiles float bytecode programs to native x86-64 code.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "jit.h"
+
+#if defined(BYTECODE_JIT_X86_64)
+    #include <sys/mman.h>
+    #include <unistd.h>
+
+    #if !defined(MAP_ANONYMOUS)
+        #define MAP_ANONYMOUS MAP_ANON
+    #endif
+#endif
+
+bool bytecode_jit_supported(void) {
+#if defined(BYTECODE_JIT_X86_64)
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if defined(BYTECODE_JIT_X86_64)
+
+// --- Code Buffer ---
+
+/// @brief Code being assembled, plus the RIP-relative loads to patch once constants are placed.
+typedef struct JitBuffer {
+    uint8_t* bytes;
+    size_t count;
+    size_t capacity;
+    bool failed; // An allocation failed; the buffer is discarded
+    uint32_t* fixups; // Offsets of disp32 fields that address a constant
+    uint32_t* targets; // Constant index each fixup refers to (0 is the sign mask)
+    size_t fixup_count;
+    double* constants; // Immediates, after the 16-byte sign mask
+    size_t constant_count;
+} JitBuffer;
+
+#define JIT_REG_RAX 0
+#define JIT_REG_RSP 4
+#define JIT_REG_RBX 3 // Callee-saved: holds the variables pointer across calls
+
+#define JIT_PREFIX_SD 0xF2 // Scalar double
+#define JIT_PREFIX_PD 0x66 // Packed double
+
+#define JIT_OP_MOVSD_LOAD 0x10
+#define JIT_OP_MOVSD_STORE 0x11
+#define JIT_OP_XORPD 0x57
+#define JIT_OP_ADDSD 0x58
+#define JIT_OP_MULSD 0x59
+#define JIT_OP_SUBSD 0x5C
+#define JIT_OP_DIVSD 0x5E
+
+#define JIT_SPILL_BYTES (8 * BYTECODE_JIT_REGISTERS) // Keeps rsp 16-byte aligned for calls
+
+static void jit_byte(JitBuffer* buffer, uint8_t byte) {
+    if (buffer->count == buffer->capacity) {
+        const size_t capacity = buffer->capacity ? buffer->capacity * 2 : 256;
+        uint8_t* bytes = realloc(buffer->bytes, capacity);
+        if (!bytes) {
+            buffer->failed = true;
+            return;
+        }
+        buffer->bytes = bytes;
+        buffer->capacity = capacity;
+    }
+    buffer->bytes[buffer->count++] = byte;
+}
+
+static void jit_word(JitBuffer* buffer, uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        jit_byte(buffer, (uint8_t) (value >> (8 * i))); // little-endian
+    }
+}
+
+static bool jit_fixup(JitBuffer* buffer, size_t target) {
+    const size_t count = buffer->fixup_count + 1;
+    uint32_t* fixups = realloc(buffer->fixups, sizeof(uint32_t) * count);
+    if (fixups) {
+        buffer->fixups = fixups;
+    }
+    uint32_t* targets = fixups ? realloc(buffer->targets, sizeof(uint32_t) * count) : NULL;
+    if (!targets) {
+        buffer->failed = true;
+        return false;
+    }
+    buffer->targets = targets;
+
+    buffer->fixups[buffer->fixup_count] = (uint32_t) buffer->count;
+    buffer->targets[buffer->fixup_count++] = (uint32_t) target;
+    return true;
+}
+
+static size_t jit_constant(JitBuffer* buffer, double value) {
+    double* constants = realloc(buffer->constants, sizeof(double) * (buffer->constant_count + 1));
+    if (!constants) {
+        buffer->failed = true;
+        return 0;
+    }
+    buffer->constants = constants;
+    buffer->constants[buffer->constant_count++] = value;
+    return buffer->constant_count; // index 0 is the sign mask
+}
+
+// --- Instruction Encoding ---
+
+/// @brief Mandatory prefix, REX for registers 8-15, then the two-byte opcode escape.
+static void jit_sse_prefix(JitBuffer* buffer, uint8_t prefix, unsigned reg, unsigned rm) {
+    jit_byte(buffer, prefix);
+    if (reg >= 8 || rm >= 8) {
+        jit_byte(buffer, (uint8_t) (0x40 | ((reg >> 3) << 2) | (rm >> 3)));
+    }
+    jit_byte(buffer, 0x0F);
+}
+
+/// @brief op xmm<dst>, xmm<src>
+static void jit_sse_reg(JitBuffer* buffer, uint8_t prefix, uint8_t op, unsigned dst, unsigned src) {
+    jit_sse_prefix(buffer, prefix, dst, src);
+    jit_byte(buffer, op);
+    jit_byte(buffer, (uint8_t) (0xC0 | ((dst & 7) << 3) | (src & 7)));
+}
+
+/// @brief op xmm<reg>, [base + disp32] (or the store form for JIT_OP_MOVSD_STORE)
+static void jit_sse_mem(
+    JitBuffer* buffer, uint8_t prefix, uint8_t op, unsigned reg, unsigned base, uint32_t disp
+) {
+    jit_sse_prefix(buffer, prefix, reg, base);
+    jit_byte(buffer, op);
+    jit_byte(buffer, (uint8_t) (0x80 | ((reg & 7) << 3) | (base & 7)));
+    if ((base & 7) == JIT_REG_RSP) {
+        jit_byte(buffer, 0x24); // SIB: rsp has no plain ModRM encoding
+    }
+    jit_word(buffer, disp, 4);
+}
+
+/// @brief op xmm<reg>, [rip + constant]; the displacement is patched in jit_link().
+static void jit_sse_constant(
+    JitBuffer* buffer, uint8_t prefix, uint8_t op, unsigned reg, size_t constant
+) {
+    jit_sse_prefix(buffer, prefix, reg, 0);
+    jit_byte(buffer, op);
+    jit_byte(buffer, (uint8_t) (0x05 | ((reg & 7) << 3)));
+    if (jit_fixup(buffer, constant)) {
+        jit_word(buffer, 0, 4);
+    }
+}
+
+static void jit_move(JitBuffer* buffer, unsigned dst, unsigned src) {
+    if (dst != src) {
+        jit_sse_reg(buffer, JIT_PREFIX_SD, JIT_OP_MOVSD_LOAD, dst, src);
+    }
+}
+
+/// @brief Calls fn(xmm<a>, xmm<b>) into xmm<a>, preserving the `a` slots below the operands.
+static void jit_call(JitBuffer* buffer, double (*fn)(double, double), unsigned a) {
+    for (unsigned i = 0; i < a; i++) {
+        jit_sse_mem(buffer, JIT_PREFIX_SD, JIT_OP_MOVSD_STORE, i, JIT_REG_RSP, 8 * i);
+    }
+
+    // Operands sit in xmm<a>, xmm<a+1>; copying upwards never overwrites an unread source
+    jit_move(buffer, 0, a);
+    jit_move(buffer, 1, a + 1);
+
+    uint64_t address = (uint64_t) (uintptr_t) fn;
+    jit_byte(buffer, 0x48); // mov rax, imm64
+    jit_byte(buffer, 0xB8 + JIT_REG_RAX);
+    jit_word(buffer, address, 8);
+    jit_byte(buffer, 0xFF); // call rax
+    jit_byte(buffer, 0xD0 + JIT_REG_RAX);
+
+    jit_move(buffer, a, 0);
+    for (unsigned i = 0; i < a; i++) {
+        jit_sse_mem(buffer, JIT_PREFIX_SD, JIT_OP_MOVSD_LOAD, i, JIT_REG_RSP, 8 * i);
+    }
+}
+
+static bool jit_has_calls(const Bytecode* program) {
+    for (size_t i = 0; i < program->count; i++) {
+        const uint8_t opcode = program->code[i].opcode;
+        if (opcode == OP_MOD || opcode == OP_POW) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// --- Translation ---
+
+static bool jit_translate(JitBuffer* buffer, const Bytecode* program) {
+    const bool calls = jit_has_calls(program);
+
+    jit_byte(buffer, 0x53); // push rbx (also aligns rsp to 16)
+    jit_byte(buffer, 0x48); // mov rbx, rdi
+    jit_byte(buffer, 0x89);
+    jit_byte(buffer, 0xFB);
+    if (calls) {
+        jit_byte(buffer, 0x48); // sub rsp, imm32
+        jit_byte(buffer, 0x81);
+        jit_byte(buffer, 0xEC);
+        jit_word(buffer, JIT_SPILL_BYTES, 4);
+    }
+
+    unsigned top = 0; // Stack depth; slot i lives in xmm<i>
+    for (size_t i = 0; i < program->count; i++) {
+        const Instruction* instruction = &program->code[i];
+        const uint8_t opcode = instruction->opcode;
+
+        if (opcode == OP_PUSH || opcode == OP_LOAD) {
+            if (top == BYTECODE_JIT_REGISTERS) {
+                return false;
+            }
+        } else if (top < (opcode == OP_NEG ? 1u : 2u)) {
+            return false; // verified programs never underflow, but never trust a stack effect
+        }
+
+        switch ((OpCode) opcode) {
+            case OP_PUSH: {
+                const size_t constant = jit_constant(buffer, instruction->operand.real);
+                jit_sse_constant(buffer, JIT_PREFIX_SD, JIT_OP_MOVSD_LOAD, top++, constant);
+                break;
+            }
+            case OP_LOAD:
+                if (instruction->operand.slot >= program->variable_count
+                    || instruction->operand.slot > INT32_MAX / 8) {
+                    return false;
+                }
+                jit_sse_mem(
+                    buffer,
+                    JIT_PREFIX_SD,
+                    JIT_OP_MOVSD_LOAD,
+                    top++,
+                    JIT_REG_RBX,
+                    (uint32_t) (8 * instruction->operand.slot)
+                );
+                break;
+            case OP_NEG:
+                jit_sse_constant(buffer, JIT_PREFIX_PD, JIT_OP_XORPD, top - 1, 0);
+                break;
+            case OP_ADD:
+                top--;
+                jit_sse_reg(buffer, JIT_PREFIX_SD, JIT_OP_ADDSD, top - 1, top);
+                break;
+            case OP_SUB:
+                top--;
+                jit_sse_reg(buffer, JIT_PREFIX_SD, JIT_OP_SUBSD, top - 1, top);
+                break;
+            case OP_MUL:
+                top--;
+                jit_sse_reg(buffer, JIT_PREFIX_SD, JIT_OP_MULSD, top - 1, top);
+                break;
+            case OP_DIV:
+                top--;
+                jit_sse_reg(buffer, JIT_PREFIX_SD, JIT_OP_DIVSD, top - 1, top);
+                break;
+            case OP_MOD:
+                top--;
+                jit_call(buffer, fmod, top - 1);
+                break;
+            case OP_POW:
+                top--;
+                jit_call(buffer, pow, top - 1);
+                break;
+            default:
+                return false;
+        }
+    }
+
+    if (top != 1) {
+        return false;
+    }
+
+    // The result is already in xmm0, where the ABI returns a double
+    if (calls) {
+        jit_byte(buffer, 0x48); // add rsp, imm32
+        jit_byte(buffer, 0x81);
+        jit_byte(buffer, 0xC4);
+        jit_word(buffer, JIT_SPILL_BYTES, 4);
+    }
+    jit_byte(buffer, 0x5B); // pop rbx
+    jit_byte(buffer, 0xC3); // ret
+    return !buffer->failed;
+}
+
+/// @brief Lays out code then constants (16-byte aligned for xorpd) and patches every reference.
+/// @return The code and constants as one image of `size` bytes.
+static uint8_t* jit_link(JitBuffer* buffer, size_t* size) {
+    const size_t pool = (buffer->count + 15) & ~(size_t) 15;
+    *size = pool + 16 + sizeof(double) * buffer->constant_count;
+
+    uint8_t* image = calloc(1, *size);
+    if (!image) {
+        return NULL;
+    }
+    memcpy(image, buffer->bytes, buffer->count);
+
+    const uint64_t sign[2] = {UINT64_C(0x8000000000000000), 0};
+    memcpy(image + pool, sign, sizeof(sign));
+    if (buffer->constant_count > 0) {
+        memcpy(image + pool + 16, buffer->constants, sizeof(double) * buffer->constant_count);
+    }
+
+    for (size_t i = 0; i < buffer->fixup_count; i++) {
+        const size_t at = buffer->fixups[i];
+        const size_t target = buffer->targets[i] == 0 ? pool : pool + 8 + 8 * buffer->targets[i];
+        const int32_t disp = (int32_t) ((int64_t) target - (int64_t) (at + 4)); // from next insn
+        memcpy(image + at, &disp, sizeof(disp));
+    }
+    return image;
+}
+
+static void jit_buffer_free(JitBuffer* buffer) {
+    free(buffer->bytes);
+    free(buffer->fixups);
+    free(buffer->targets);
+    free(buffer->constants);
+}
+
+// --- Native Lifecycle ---
+
+_Static_assert(
+    sizeof(BytecodeJitFunction) == sizeof(void*), "code pointers must be object-pointer sized"
+);
+
+BytecodeJit* bytecode_jit_compile(const Bytecode* program) {
+    if (!program || !program->code || program->count == 0 || program->integral
+        || program->depth > BYTECODE_JIT_REGISTERS) {
+        return NULL;
+    }
+
+    JitBuffer buffer = {0};
+    size_t size = 0;
+    uint8_t* image = jit_translate(&buffer, program) ? jit_link(&buffer, &size) : NULL;
+    jit_buffer_free(&buffer);
+    if (!image) {
+        return NULL;
+    }
+
+    const long page = sysconf(_SC_PAGESIZE);
+    const size_t granule = page > 0 ? (size_t) page : 4096;
+    const size_t length = (size + granule - 1) / granule * granule;
+
+    BytecodeJit* jit = malloc(sizeof(BytecodeJit));
+    void* memory = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (!jit || memory == MAP_FAILED) {
+        free(jit);
+        free(image);
+        if (memory != MAP_FAILED) {
+            munmap(memory, length);
+        }
+        return NULL;
+    }
+
+    memcpy(memory, image, size);
+    free(image);
+    if (mprotect(memory, length, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, length); // e.g. a policy that forbids executable mappings
+        free(jit);
+        return NULL;
+    }
+
+    // ISO C has no object-to-function pointer cast; POSIX guarantees the representation matches
+    memcpy(&jit->function, &memory, sizeof(jit->function));
+    jit->memory = memory;
+    jit->size = length;
+    return jit;
+}
+
+void bytecode_jit_free(BytecodeJit* jit) {
+    if (jit) {
+        munmap(jit->memory, jit->size);
+        free(jit);
+    }
+}
+
+#else
+
+// --- Unsupported Platforms ---
+
+BytecodeJit* bytecode_jit_compile(const Bytecode* program) {
+    (void) program;
+    return NULL;
+}
+
+void bytecode_jit_free(BytecodeJit* jit) {
+    free(jit);
+}
+
+#endif // BYTECODE_JIT_X86_64
@@ -9,35 +9,239 @@
 
 #include <stdlib.h>
 #include <assert.h>
-#include <ctype.h>
 #include <string.h>
+#include <float.h>
 #include <stdio.h>
 
 #include "lexer/token.h"
+#include "stats.h"
+
+#if defined(TOKEN_SCAN_SSE2)
+    #include <emmintrin.h>
+#endif
+
+// --- Character Classification Table ---
+
+#define TOKEN_CHAR_DIGIT_ENTRY (TOKEN_CHAR_DIGIT | TOKEN_TYPE_INTEGER)
+#define TOKEN_CHAR_IDENT_ENTRY (TOKEN_CHAR_IDENT | TOKEN_TYPE_IDENTIFIER)
+
+const uint8_t token_char_table[256] = {
+    // Whitespace
+    [' '] = TOKEN_CHAR_SPACE,
+    ['\t'] = TOKEN_CHAR_SPACE,
+    ['\n'] = TOKEN_CHAR_SPACE,
+    ['\v'] = TOKEN_CHAR_SPACE,
+    ['\f'] = TOKEN_CHAR_SPACE,
+    ['\r'] = TOKEN_CHAR_SPACE,
+
+    // Operators
+    ['+'] = TOKEN_CHAR_SYMBOL | TOKEN_TYPE_PLUS,
+    ['-'] = TOKEN_CHAR_SYMBOL | TOKEN_TYPE_MINUS,
+    ['*'] = TOKEN_CHAR_SYMBOL | TOKEN_TYPE_STAR,
+    ['/'] = TOKEN_CHAR_SYMBOL | TOKEN_TYPE_SLASH,
+    ['%'] = TOKEN_CHAR_SYMBOL | TOKEN_TYPE_MOD,
+
+    // Grouping
+    ['('] = TOKEN_CHAR_SYMBOL | TOKEN_TYPE_LEFT_PAREN,
+    [')'] = TOKEN_CHAR_SYMBOL | TOKEN_TYPE_RIGHT_PAREN,
+
+    // Literals
+    ['0'] = TOKEN_CHAR_DIGIT_ENTRY, ['1'] = TOKEN_CHAR_DIGIT_ENTRY, ['2'] = TOKEN_CHAR_DIGIT_ENTRY,
+    ['3'] = TOKEN_CHAR_DIGIT_ENTRY, ['4'] = TOKEN_CHAR_DIGIT_ENTRY, ['5'] = TOKEN_CHAR_DIGIT_ENTRY,
+    ['6'] = TOKEN_CHAR_DIGIT_ENTRY, ['7'] = TOKEN_CHAR_DIGIT_ENTRY, ['8'] = TOKEN_CHAR_DIGIT_ENTRY,
+    ['9'] = TOKEN_CHAR_DIGIT_ENTRY,
+
+    // Identifiers
+    ['_'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['A'] = TOKEN_CHAR_IDENT_ENTRY, ['B'] = TOKEN_CHAR_IDENT_ENTRY, ['C'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['D'] = TOKEN_CHAR_IDENT_ENTRY, ['E'] = TOKEN_CHAR_IDENT_ENTRY, ['F'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['G'] = TOKEN_CHAR_IDENT_ENTRY, ['H'] = TOKEN_CHAR_IDENT_ENTRY, ['I'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['J'] = TOKEN_CHAR_IDENT_ENTRY, ['K'] = TOKEN_CHAR_IDENT_ENTRY, ['L'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['M'] = TOKEN_CHAR_IDENT_ENTRY, ['N'] = TOKEN_CHAR_IDENT_ENTRY, ['O'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['P'] = TOKEN_CHAR_IDENT_ENTRY, ['Q'] = TOKEN_CHAR_IDENT_ENTRY, ['R'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['S'] = TOKEN_CHAR_IDENT_ENTRY, ['T'] = TOKEN_CHAR_IDENT_ENTRY, ['U'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['V'] = TOKEN_CHAR_IDENT_ENTRY, ['W'] = TOKEN_CHAR_IDENT_ENTRY, ['X'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['Y'] = TOKEN_CHAR_IDENT_ENTRY, ['Z'] = TOKEN_CHAR_IDENT_ENTRY, ['a'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['b'] = TOKEN_CHAR_IDENT_ENTRY, ['c'] = TOKEN_CHAR_IDENT_ENTRY, ['d'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['e'] = TOKEN_CHAR_IDENT_ENTRY, ['f'] = TOKEN_CHAR_IDENT_ENTRY, ['g'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['h'] = TOKEN_CHAR_IDENT_ENTRY, ['i'] = TOKEN_CHAR_IDENT_ENTRY, ['j'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['k'] = TOKEN_CHAR_IDENT_ENTRY, ['l'] = TOKEN_CHAR_IDENT_ENTRY, ['m'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['n'] = TOKEN_CHAR_IDENT_ENTRY, ['o'] = TOKEN_CHAR_IDENT_ENTRY, ['p'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['q'] = TOKEN_CHAR_IDENT_ENTRY, ['r'] = TOKEN_CHAR_IDENT_ENTRY, ['s'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['t'] = TOKEN_CHAR_IDENT_ENTRY, ['u'] = TOKEN_CHAR_IDENT_ENTRY, ['v'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['w'] = TOKEN_CHAR_IDENT_ENTRY, ['x'] = TOKEN_CHAR_IDENT_ENTRY, ['y'] = TOKEN_CHAR_IDENT_ENTRY,
+    ['z'] = TOKEN_CHAR_IDENT_ENTRY,
+};
+
+// --- Operator Descriptor Table ---
+
+_Static_assert(TOKEN_TYPE_IDENTIFIER < TOKEN_DESCRIPTOR_TYPES, "TokenType must fit in a nibble");
+_Static_assert(TOKEN_ROLE_BINARY < TOKEN_DESCRIPTOR_ROLES, "TokenRole must fit in two bits");
+
+#define TOKEN_DESCRIBE(kind, precedence, association, arity) \
+    {TOKEN_KIND_##kind, TOKEN_PRECEDENT_##precedence, TOKEN_ASSOCIATE_##association, arity}
+
+// Every role shares the kind of each type; only operator entries differ between rows
+#define TOKEN_DESCRIBE_OPERANDS \
+    [TOKEN_TYPE_INTEGER] = TOKEN_DESCRIBE(LITERAL, NONE, NONE, 0), \
+    [TOKEN_TYPE_FLOAT] = TOKEN_DESCRIBE(LITERAL, NONE, NONE, 0), \
+    [TOKEN_TYPE_LEFT_PAREN] = TOKEN_DESCRIBE(GROUP, NONE, NONE, 0), \
+    [TOKEN_TYPE_RIGHT_PAREN] = TOKEN_DESCRIBE(GROUP, NONE, NONE, 0), \
+    [TOKEN_TYPE_IDENTIFIER] = TOKEN_DESCRIBE(IDENTIFIER, NONE, NONE, 0)
+
+const TokenDescriptor token_descriptor_table[TOKEN_DESCRIPTOR_ROLES][TOKEN_DESCRIPTOR_TYPES] = {
+    // Operators not yet resolved by the parser
+    [TOKEN_ROLE_NONE] = {
+        TOKEN_DESCRIBE_OPERANDS,
+        [TOKEN_TYPE_PLUS] = TOKEN_DESCRIBE(OPERATOR, NONE, NONE, 0),
+        [TOKEN_TYPE_MINUS] = TOKEN_DESCRIBE(OPERATOR, NONE, NONE, 0),
+        [TOKEN_TYPE_STAR] = TOKEN_DESCRIBE(OPERATOR, NONE, NONE, 0),
+        [TOKEN_TYPE_SLASH] = TOKEN_DESCRIBE(OPERATOR, NONE, NONE, 0),
+        [TOKEN_TYPE_MOD] = TOKEN_DESCRIBE(OPERATOR, NONE, NONE, 0),
+        [TOKEN_TYPE_POWER] = TOKEN_DESCRIBE(OPERATOR, NONE, NONE, 0),
+    },
+
+    // Prefix operators; an arity of 0 means the operator has no unary form
+    [TOKEN_ROLE_UNARY] = {
+        TOKEN_DESCRIBE_OPERANDS,
+        [TOKEN_TYPE_PLUS] = TOKEN_DESCRIBE(OPERATOR, UNARY, RIGHT, 1),
+        [TOKEN_TYPE_MINUS] = TOKEN_DESCRIBE(OPERATOR, UNARY, RIGHT, 1),
+        [TOKEN_TYPE_STAR] = TOKEN_DESCRIBE(OPERATOR, NONE, NONE, 0),
+        [TOKEN_TYPE_SLASH] = TOKEN_DESCRIBE(OPERATOR, NONE, NONE, 0),
+        [TOKEN_TYPE_MOD] = TOKEN_DESCRIBE(OPERATOR, NONE, NONE, 0),
+        [TOKEN_TYPE_POWER] = TOKEN_DESCRIBE(OPERATOR, NONE, NONE, 0),
+    },
+
+    // Infix operators
+    [TOKEN_ROLE_BINARY] = {
+        TOKEN_DESCRIBE_OPERANDS,
+        [TOKEN_TYPE_PLUS] = TOKEN_DESCRIBE(OPERATOR, ADDITIVE, LEFT, 2),
+        [TOKEN_TYPE_MINUS] = TOKEN_DESCRIBE(OPERATOR, ADDITIVE, LEFT, 2),
+        [TOKEN_TYPE_STAR] = TOKEN_DESCRIBE(OPERATOR, MULTIPLICATIVE, LEFT, 2),
+        [TOKEN_TYPE_SLASH] = TOKEN_DESCRIBE(OPERATOR, MULTIPLICATIVE, LEFT, 2),
+        [TOKEN_TYPE_MOD] = TOKEN_DESCRIBE(OPERATOR, MULTIPLICATIVE, LEFT, 2),
+        [TOKEN_TYPE_POWER] = TOKEN_DESCRIBE(OPERATOR, POWER, RIGHT, 2),
+    },
+};
 
 // --- ASCII Character Classification ---
 
 bool isop(const char s) {
-    switch (s) {
-        case '+': // addition
-        case '-': // subtraction
-        case '*': // multiplication
-        case '/': // division
-        case '%': // modulus
-            return true;
-        default:
-            return false;
-    }
+    return token_char_class(s) == TOKEN_CHAR_SYMBOL
+           && token_descriptor(token_char_type(s), TOKEN_ROLE_NONE)->kind == TOKEN_KIND_OPERATOR;
 }
 
 bool isgroup(const char s) {
-    switch (s) {
-        case '(':
-        case ')':
-            return true;
-        default:
-            return false;
+    return token_char_class(s) == TOKEN_CHAR_SYMBOL
+           && token_descriptor(token_char_type(s), TOKEN_ROLE_NONE)->kind == TOKEN_KIND_GROUP;
+}
+
+bool isident(const char s) {
+    return token_char_class(s) == TOKEN_CHAR_IDENT;
+}
+
+// --- Lexeme Scanning ---
+
+TokenType token_type_from_char(const char s) {
+    return token_char_class(s) == TOKEN_CHAR_SYMBOL ? token_char_type(s) : TOKEN_TYPE_NONE;
+}
+
+size_t token_scan_symbol(const char* lexeme, size_t length, TokenType* type) {
+    TokenType symbol = length > 0 ? token_type_from_char(*lexeme) : TOKEN_TYPE_NONE;
+    size_t span = symbol != TOKEN_TYPE_NONE ? 1 : 0;
+
+    // A NUL stops the scan, so the second byte is only read when the first one exists
+    if (symbol == TOKEN_TYPE_STAR && length > 1 && lexeme[1] == '*') {
+        symbol = TOKEN_TYPE_POWER;
+        span = 2;
+    }
+
+    if (type) {
+        *type = symbol;
+    }
+    return span;
+}
+
+/// @brief Length of the run of ASCII digits at the start of s.
+/// @note The SSE2 path tests 16 bytes per step and only runs within a real bound, never on
+///       unbounded (SIZE_MAX) C strings, so it cannot read past the end of the buffer.
+static size_t token_scan_digits(const char* s, size_t length) {
+    size_t span = 0;
+
+#if defined(TOKEN_SCAN_SSE2)
+    if (length != SIZE_MAX) {
+        const __m128i lower = _mm_set1_epi8('0' - 1);
+        const __m128i upper = _mm_set1_epi8('9' + 1);
+        while (length - span >= 16) {
+            const __m128i chunk = _mm_loadu_si128((const __m128i*) (s + span));
+            const __m128i is_digit
+                = _mm_and_si128(_mm_cmpgt_epi8(chunk, lower), _mm_cmplt_epi8(chunk, upper));
+            const unsigned mask = (unsigned) _mm_movemask_epi8(is_digit);
+            if (mask != 0xFFFF) {
+                return span + (size_t) __builtin_ctz(~mask);
+            }
+            span += 16;
+        }
+    }
+#endif
+
+    while (span < length && token_char_class(s[span]) == TOKEN_CHAR_DIGIT) {
+        span++;
+    }
+    return span;
+}
+
+/// @brief Bound left after span bytes (C strings stay unbounded).
+static size_t token_scan_rest(size_t length, size_t span) {
+    return length == SIZE_MAX ? SIZE_MAX : length - span;
+}
+
+static bool token_is_exponent_marker(char c) {
+    return c == 'e' || c == 'E';
+}
+
+size_t token_scan_number(const char* lexeme, size_t length, TokenType* type) {
+    size_t span = token_scan_digits(lexeme, length);
+    bool real = false;
+
+    if (span < length && lexeme[span] == '.') {
+        real = true;
+        span++;
+        span += token_scan_digits(lexeme + span, token_scan_rest(length, span));
+    }
+
+    // The exponent belongs to the number only once a digit follows the marker and its sign.
+    // Each byte is read only after the one before it proved non-NUL, so C strings stay in bounds.
+    if (span < length && token_is_exponent_marker(lexeme[span])) {
+        size_t digits = span + 1;
+        if (digits < length && (lexeme[digits] == '+' || lexeme[digits] == '-')) {
+            digits++;
+        }
+        if (digits < length && token_char_class(lexeme[digits]) == TOKEN_CHAR_DIGIT) {
+            real = true;
+            span = digits + token_scan_digits(lexeme + digits, token_scan_rest(length, digits));
+        }
+    }
+
+    if (type) {
+        *type = real ? TOKEN_TYPE_FLOAT : TOKEN_TYPE_INTEGER;
     }
+    return span;
+}
+
+size_t token_scan_identifier(const char* lexeme, size_t length) {
+    size_t span = 0;
+    if (span < length && isident(lexeme[span])) {
+        span++;
+        while (span < length) {
+            const uint8_t class = token_char_class(lexeme[span]);
+            if (class != TOKEN_CHAR_IDENT && class != TOKEN_CHAR_DIGIT) {
+                break;
+            }
+            span++;
+        }
+    }
+    return span;
 }
 
 // --- Token Precedent Classification ---
@@ -47,214 +251,428 @@ Precedent token_precedence(const Token* token) {
         return TOKEN_PRECEDENT_ERROR;
     }
 
-    switch (token->type) {
-        case TOKEN_TYPE_PLUS:
-        case TOKEN_TYPE_MINUS:
-            return TOKEN_PRECEDENT_ADDITIVE;
-        case TOKEN_TYPE_STAR:
-        case TOKEN_TYPE_SLASH:
-        case TOKEN_TYPE_MOD:
-            return TOKEN_PRECEDENT_MULTIPLICATIVE;
-        default:
-            return TOKEN_PRECEDENT_NONE;
-    }
+    return (Precedent) token_descriptor(token->type, token->role)->precedence;
 }
 
 // --- Token Lifecycle Management ---
 
-Token* token_create(const char* lexeme, const size_t size) {
+/// @note A NULL arena selects the heap: the token and its lexeme are owned by the caller.
+/// @note A view token borrows the lexeme from the source instead of copying it.
+static Token* token_alloc(Arena* arena, const char* lexeme, const size_t size, bool view) {
     if (!lexeme) {
         return NULL;
     }
 
-    Token* token = malloc(sizeof(Token));
+    Token* token = arena ? arena_alloc(arena, sizeof(Token)) : malloc(sizeof(Token));
     if (!token) {
         return NULL;
     }
 
-    token->lexeme = strndup(lexeme, size);
-    if (!token->lexeme) {
-        free(token);
-        return NULL;
+    token->view = view;
+    if (view) {
+        token->lexeme = lexeme;
+        token->size = size;
+    } else if (arena) {
+        token->lexeme = arena_strndup(arena, lexeme, size);
+        if (!token->lexeme) {
+            return NULL;
+        }
+        token->size = size;
+    } else {
+        char* copy = strndup(lexeme, size);
+        if (!copy) {
+            free(token);
+            return NULL;
+        }
+        token->lexeme = copy;
+        token->size = strlen(copy);
     }
 
-    token->size = strlen(token->lexeme);
     token->type = TOKEN_TYPE_NONE;
-    token->kind = TOKEN_KIND_NONE;
     token->role = TOKEN_ROLE_NONE;
-    token->association = TOKEN_ASSOCIATE_NONE;
-    token->precedence = TOKEN_PRECEDENT_NONE;
+    token->value.integer = 0;
+    token->decoded = false;
 
     return token;
 }
 
-Token* token_create_number(const char* lexeme) {
-    if (!lexeme) {
-        return NULL;
-    }
-
-    size_t span = 0;
-    const char* start = lexeme;
-    bool seen_dot = false;
-
-    while (*lexeme) {
-        if (isdigit(*lexeme)) {
-            span++;
-        } else if (!seen_dot && *lexeme == '.') {
-            seen_dot = true;
-            span++;
-        } else {
-            break;
-        }
-        lexeme++;
-    }
+/// @brief Sets the type; operators start out binary until the parser resolves unary position.
+static void token_classify(Token* token, TokenType type) {
+    token->type = (uint8_t) type;
+    token->role = token_descriptor(type, TOKEN_ROLE_BINARY)->arity == 2 ? TOKEN_ROLE_BINARY
+                                                                        : TOKEN_ROLE_NONE;
+}
 
-    Token* token = token_create(start, span);
+static Token* token_alloc_typed(
+    Arena* arena, const char* lexeme, const size_t size, TokenType type, bool view
+) {
+    Token* token = token_alloc(arena, lexeme, size, view);
     if (!token) {
         return NULL;
     }
 
-    token->precedence = TOKEN_PRECEDENT_NONE;
-    token->association = TOKEN_ASSOCIATE_NONE;
-    token->role = TOKEN_ROLE_NONE;
-    token->kind = TOKEN_KIND_LITERAL;
-    token->type = seen_dot ? TOKEN_TYPE_FLOAT : TOKEN_TYPE_INTEGER;
-
+    token_classify(token, type);
+    if (token_is_number(token)) {
+        token->decoded = token_decode_number(token->lexeme, token->size, type, &token->value);
+    }
     return token;
 }
 
-Token* token_create_operator(const char* lexeme) {
-    if (!isop(*lexeme)) {
+static Token* token_alloc_number(Arena* arena, const char* lexeme, bool view) {
+    if (!lexeme) {
         return NULL;
     }
 
-    Token* token = token_create(lexeme, 1);
-    if (!token) {
-        return NULL;
-    }
+    TokenType type = TOKEN_TYPE_NONE;
+    size_t span = token_scan_number(lexeme, SIZE_MAX, &type);
+    return token_alloc_typed(arena, lexeme, span, type, view);
+}
 
-    if (*lexeme == '+') {
-        token->type = TOKEN_TYPE_PLUS;
-    } else if (*lexeme == '-') {
-        token->type = TOKEN_TYPE_MINUS;
-    } else if (*lexeme == '*') {
-        token->type = TOKEN_TYPE_STAR;
-    } else if (*lexeme == '/') {
-        token->type = TOKEN_TYPE_SLASH;
-    } else if (*lexeme == '%') {
-        token->type = TOKEN_TYPE_MOD;
-    } else {
-        token->type = TOKEN_TYPE_NONE;
+static Token* token_alloc_operator(Arena* arena, const char* lexeme, bool view) {
+    if (!lexeme || !isop(*lexeme)) {
+        return NULL;
     }
 
-    token->precedence = token_precedence(token);
-    token->association = TOKEN_ASSOCIATE_LEFT;
-    token->role = TOKEN_ROLE_BINARY;
-    token->kind = TOKEN_KIND_OPERATOR;
-
-    return token;
+    TokenType type = TOKEN_TYPE_NONE;
+    size_t span = token_scan_symbol(lexeme, SIZE_MAX, &type);
+    return token_alloc_typed(arena, lexeme, span, type, view);
 }
 
-Token* token_create_group(const char* lexeme) {
-    if (!isgroup(*lexeme)) {
+static Token* token_alloc_group(Arena* arena, const char* lexeme, bool view) {
+    if (!lexeme || !isgroup(*lexeme)) {
         return NULL;
     }
 
-    Token* token = token_create(lexeme, 1);
-    if (!token) {
-        return NULL;
-    }
+    return token_alloc_typed(arena, lexeme, 1, token_type_from_char(*lexeme), view);
+}
 
-    if (*lexeme == '(') {
-        token->type = TOKEN_TYPE_LEFT_PAREN;
-    } else if (*lexeme == ')') {
-        token->type = TOKEN_TYPE_RIGHT_PAREN;
-    } else {
-        token->type = TOKEN_TYPE_NONE;
+static Token* token_alloc_identifier(Arena* arena, const char* lexeme, bool view) {
+    if (!lexeme || !isident(*lexeme)) {
+        return NULL;
     }
 
-    token->precedence = TOKEN_PRECEDENT_NONE;
-    token->association = TOKEN_ASSOCIATE_NONE;
-    token->role = TOKEN_ROLE_NONE;
-    token->kind = TOKEN_KIND_GROUP;
-
-    return token;
+    size_t span = token_scan_identifier(lexeme, SIZE_MAX);
+    return token_alloc_typed(arena, lexeme, span, TOKEN_TYPE_IDENTIFIER, view);
 }
 
-Token* token_clone(const Token* token) {
+static Token* token_alloc_clone(Arena* arena, const Token* token) {
     if (!token) {
         return NULL;
     }
 
-    Token* clone = token_create(token->lexeme, token->size);
+    Token* clone = token_alloc(arena, token->lexeme, token->size, token->view);
     if (!clone) {
         return NULL;
     }
 
-    clone->precedence = token->precedence;
-    clone->association = token->association;
-    clone->role = token->role;
-    clone->kind = token->kind;
     clone->type = token->type;
+    clone->role = token->role;
+    clone->value = token->value;
+    clone->decoded = token->decoded;
 
     return clone;
 }
 
+Token* token_create(const char* lexeme, const size_t size) {
+    return token_alloc(NULL, lexeme, size, false);
+}
+
+Token* token_create_number(const char* lexeme) {
+    return token_alloc_number(NULL, lexeme, false);
+}
+
+Token* token_create_operator(const char* lexeme) {
+    return token_alloc_operator(NULL, lexeme, false);
+}
+
+Token* token_create_group(const char* lexeme) {
+    return token_alloc_group(NULL, lexeme, false);
+}
+
+Token* token_create_identifier(const char* lexeme) {
+    return token_alloc_identifier(NULL, lexeme, false);
+}
+
+Token* token_create_typed(
+    Arena* arena, const char* lexeme, const size_t size, TokenType type, bool view
+) {
+    return token_alloc_typed(arena, lexeme, size, type, view);
+}
+
+Token* token_clone(const Token* token) {
+    SHUNT_STAT_INC(SHUNT_STAT_TOKEN_CLONES);
+    return token_alloc_clone(NULL, token);
+}
+
 void token_free(Token* token) {
     if (token) {
-        if (token->lexeme) {
-            free(token->lexeme);
-            token->lexeme = NULL;
+        if (token->lexeme && !token->view) {
+            free((char*) token->lexeme);
         }
+        token->lexeme = NULL;
         free(token);
     }
 }
 
-// --- Token Classification ---
+// --- Arena-backed Token Lifecycle ---
 
-bool token_is_number(const Token* token) {
-    if (!token) {
+Token* token_arena_create(Arena* arena, const char* lexeme, const size_t size) {
+    return arena ? token_alloc(arena, lexeme, size, false) : NULL;
+}
+
+Token* token_arena_create_number(Arena* arena, const char* lexeme) {
+    return arena ? token_alloc_number(arena, lexeme, false) : NULL;
+}
+
+Token* token_arena_create_operator(Arena* arena, const char* lexeme) {
+    return arena ? token_alloc_operator(arena, lexeme, false) : NULL;
+}
+
+Token* token_arena_create_group(Arena* arena, const char* lexeme) {
+    return arena ? token_alloc_group(arena, lexeme, false) : NULL;
+}
+
+Token* token_arena_create_identifier(Arena* arena, const char* lexeme) {
+    return arena ? token_alloc_identifier(arena, lexeme, false) : NULL;
+}
+
+Token* token_arena_clone(Arena* arena, const Token* token) {
+    return arena ? token_alloc_clone(arena, token) : NULL;
+}
+
+// --- View Token Lifecycle ---
+
+Token* token_view_create(Arena* arena, const char* lexeme, const size_t size) {
+    return token_alloc(arena, lexeme, size, true);
+}
+
+Token* token_view_create_number(Arena* arena, const char* lexeme) {
+    return token_alloc_number(arena, lexeme, true);
+}
+
+Token* token_view_create_operator(Arena* arena, const char* lexeme) {
+    return token_alloc_operator(arena, lexeme, true);
+}
+
+Token* token_view_create_group(Arena* arena, const char* lexeme) {
+    return token_alloc_group(arena, lexeme, true);
+}
+
+Token* token_view_create_identifier(Arena* arena, const char* lexeme) {
+    return token_alloc_identifier(arena, lexeme, true);
+}
+
+// --- Token Literal Decoding ---
+
+#define TOKEN_EXACT_MANTISSA (1ull << 53) // Every integer up to here is exact in a double
+#define TOKEN_EXACT_POWER 22 // 10^22 is the largest power of ten that is exact in a double
+#define TOKEN_MANTISSA_DIGITS 19 // Significant digits that always fit a uint64_t
+#define TOKEN_EXPONENT_LIMIT 100000 // Far past any finite double; larger exponents saturate
+
+static const double token_exact_powers[TOKEN_EXACT_POWER + 1] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static bool token_is_digit(char c) {
+    return (unsigned) (c - '0') <= 9;
+}
+
+static bool token_decode_integer(const char* lexeme, size_t size, int64_t* value) {
+    uint64_t result = 0;
+    for (size_t i = 0; i < size; i++) {
+        const unsigned digit = (unsigned) (lexeme[i] - '0');
+        if (digit > 9 || result > ((uint64_t) INT64_MAX - digit) / 10) {
+            return false; // not a digit or out of range
+        }
+        result = result * 10 + digit;
+    }
+
+    *value = (int64_t) result;
+    return size > 0;
+}
+
+/// @brief strtod() on a bounded copy, since view lexemes are not terminated.
+static bool token_decode_float_slow(const char* lexeme, size_t size, double* value) {
+    char buffer[64];
+    char* text = size < sizeof(buffer) ? buffer : malloc(size + 1);
+    if (!text) {
+        return false;
+    }
+    memcpy(text, lexeme, size);
+    text[size] = '\0';
+
+    char* end = NULL;
+    *value = strtod(text, &end);
+    bool ok = end == text + size;
+
+    if (text != buffer) {
+        free(text);
+    }
+    return ok;
+}
+
+/// @brief Clinger's fast path: a mantissa and a power of ten that are both exact in a double give
+///        a correctly rounded product or quotient in one IEEE operation.
+/// @return false if the literal needs the slow path (too many digits, or a large exponent).
+static bool token_decode_float_fast(uint64_t mantissa, int64_t exponent, double* value) {
+    if (mantissa > TOKEN_EXACT_MANTISSA) {
+        return false;
+    }
+
+    if (mantissa == 0) {
+        *value = 0.0;
+        return true;
+    }
+
+    if (exponent < 0) {
+        if (exponent < -TOKEN_EXACT_POWER) {
+            return false;
+        }
+        *value = (double) mantissa / token_exact_powers[-exponent];
+        return true;
+    }
+
+    // A short mantissa can absorb part of a large exponent and stay exact: 2e30 is 2e8 * 1e22
+    while (exponent > TOKEN_EXACT_POWER) {
+        if (mantissa > TOKEN_EXACT_MANTISSA / 10) {
+            return false;
+        }
+        mantissa *= 10;
+        exponent--;
+    }
+    *value = (double) mantissa * token_exact_powers[exponent];
+    return true;
+}
+
+static bool token_decode_float(const char* lexeme, size_t size, double* value) {
+    size_t i = 0;
+    if (size == 0 || !token_is_digit(lexeme[0])) {
+        return false; // the grammar has no leading '.' or sign
+    }
+
+    uint64_t mantissa = 0;
+    int64_t exponent = 0; // Power of ten the mantissa is scaled by
+    size_t digits = 0; // Significant digits in the mantissa
+    bool exact = true; // Every significant digit fit the mantissa
+    bool fraction = false;
+    for (; i < size; i++) {
+        const char c = lexeme[i];
+        if (c == '.' && !fraction) {
+            fraction = true;
+            continue;
+        }
+        if (!token_is_digit(c)) {
+            break;
+        }
+
+        if (digits < TOKEN_MANTISSA_DIGITS) {
+            mantissa = mantissa * 10 + (uint64_t) (c - '0');
+            digits += mantissa != 0; // leading zeros are not significant
+            exponent -= fraction;
+        } else if (c != '0' || !fraction) {
+            exact = false; // the slow path rounds the digits that do not fit
+        }
+    }
+
+    if (i < size && token_is_exponent_marker(lexeme[i])) {
+        i++;
+        const bool negative = i < size && lexeme[i] == '-';
+        if (i < size && (lexeme[i] == '+' || lexeme[i] == '-')) {
+            i++;
+        }
+        if (i == size || !token_is_digit(lexeme[i])) {
+            return false; // the marker needs digits
+        }
+
+        int64_t power = 0;
+        for (; i < size && token_is_digit(lexeme[i]); i++) {
+            if (power < TOKEN_EXPONENT_LIMIT) {
+                power = power * 10 + (lexeme[i] - '0');
+            }
+        }
+        exponent += negative ? -power : power;
+    }
+
+    if (i != size) {
+        return false; // not a whole literal
+    }
+
+#if FLT_EVAL_METHOD == 0
+    // Extended-precision evaluation (x87) would round twice, so only plain doubles take it
+    if (exact && token_decode_float_fast(mantissa, exponent, value)) {
+        return true;
+    }
+#endif
+    return token_decode_float_slow(lexeme, size, value);
+}
+
+bool token_decode_number(const char* lexeme, size_t size, TokenType type, TokenValue* value) {
+    if (!lexeme || !value) {
         return false;
     }
 
-    switch (token->type) {
+    switch (type) {
         case TOKEN_TYPE_INTEGER:
+            return token_decode_integer(lexeme, size, &value->integer);
         case TOKEN_TYPE_FLOAT:
-            return true;
+            return token_decode_float(lexeme, size, &value->real);
         default:
             return false;
     }
 }
 
-bool token_is_operator(const Token* token) {
-    if (!token) {
+bool token_to_integer(const Token* token, int64_t* value) {
+    if (!token_is_type_integer(token) || !value || token->size == 0) {
         return false;
     }
 
-    switch (token->type) {
-        case TOKEN_TYPE_PLUS:
-        case TOKEN_TYPE_MINUS:
-        case TOKEN_TYPE_STAR:
-        case TOKEN_TYPE_SLASH:
-        case TOKEN_TYPE_MOD:
-            return true;
-        default:
-            return false;
+    if (token->decoded) {
+        *value = token->value.integer;
+        return true;
+    }
+    return token_decode_integer(token->lexeme, token->size, value);
+}
+
+bool token_to_float(const Token* token, double* value) {
+    if (!token_is_number(token) || !value || token->size == 0) {
+        return false;
+    }
+
+    if (token->decoded) {
+        *value = token_is_type_integer(token) ? (double) token->value.integer : token->value.real;
+        return true;
     }
+
+    // Integer lexemes are valid float syntax too, e.g. ones too large for an int64_t
+    return token_decode_float(token->lexeme, token->size, value);
+}
+
+// --- Token Classification ---
+
+static TokenKind token_kind(const Token* token) {
+    return (TokenKind) token_descriptor(token->type, token->role)->kind;
+}
+
+bool token_is_number(const Token* token) {
+    return token && token_kind(token) == TOKEN_KIND_LITERAL;
+}
+
+bool token_is_operator(const Token* token) {
+    return token && token_kind(token) == TOKEN_KIND_OPERATOR;
 }
 
 bool token_is_group(const Token* token) {
+    return token && token_kind(token) == TOKEN_KIND_GROUP;
+}
+
+bool token_is_operand(const Token* token) {
     if (!token) {
         return false;
     }
 
-    switch (token->type) {
-        case TOKEN_TYPE_LEFT_PAREN:
-        case TOKEN_TYPE_RIGHT_PAREN:
-            return true;
-        default:
-            return false;
-    }
+    const TokenKind kind = token_kind(token);
+    return kind == TOKEN_KIND_LITERAL || kind == TOKEN_KIND_IDENTIFIER;
 }
 
 // --- Token Role Classification ---
@@ -278,7 +696,7 @@ bool token_is_role_binary(const Token* token) {
 // --- Token Kind Classification ---
 
 bool token_is_kind(const Token* token, TokenKind kind) {
-    return token && token->kind == kind;
+    return token && token_kind(token) == kind;
 }
 
 bool token_is_kind_none(const Token* token) {
@@ -297,6 +715,10 @@ bool token_is_kind_group(const Token* token) {
     return token_is_kind(token, TOKEN_KIND_GROUP);
 }
 
+bool token_is_kind_identifier(const Token* token) {
+    return token_is_kind(token, TOKEN_KIND_IDENTIFIER);
+}
+
 // --- Token Type Classification ---
 
 bool token_is_type(const Token* token, TokenType type) {
@@ -335,6 +757,10 @@ bool token_is_type_mod(const Token* token) {
     return token_is_type(token, TOKEN_TYPE_MOD);
 }
 
+bool token_is_type_power(const Token* token) {
+    return token_is_type(token, TOKEN_TYPE_POWER);
+}
+
 bool token_is_type_left_paren(const Token* token) {
     return token_is_type(token, TOKEN_TYPE_LEFT_PAREN);
 }
@@ -343,10 +769,14 @@ bool token_is_type_right_paren(const Token* token) {
     return token_is_type(token, TOKEN_TYPE_RIGHT_PAREN);
 }
 
+bool token_is_type_identifier(const Token* token) {
+    return token_is_type(token, TOKEN_TYPE_IDENTIFIER);
+}
+
 // --- Token Associativity Classification ---
 
 bool token_is_associate(const Token* token, Associate association) {
-    return token && token->association == association;
+    return token && token_descriptor(token->type, token->role)->association == association;
 }
 
 bool token_is_associate_none(const Token* token) {
@@ -363,52 +793,62 @@ bool token_is_associate_right(const Token* token) {
 
 // --- Token to String Conversion Functions ---
 
+static const char* const token_type_names[TOKEN_DESCRIPTOR_TYPES] = {
+    [TOKEN_TYPE_NONE] = "NONE",
+    [TOKEN_TYPE_INTEGER] = "INTEGER",
+    [TOKEN_TYPE_FLOAT] = "FLOAT",
+    [TOKEN_TYPE_PLUS] = "PLUS",
+    [TOKEN_TYPE_MINUS] = "MINUS",
+    [TOKEN_TYPE_STAR] = "STAR",
+    [TOKEN_TYPE_SLASH] = "SLASH",
+    [TOKEN_TYPE_MOD] = "MOD",
+    [TOKEN_TYPE_POWER] = "POWER",
+    [TOKEN_TYPE_LEFT_PAREN] = "LEFT_PAREN",
+    [TOKEN_TYPE_RIGHT_PAREN] = "RIGHT_PAREN",
+    [TOKEN_TYPE_IDENTIFIER] = "IDENTIFIER",
+};
+
+static const char* const token_kind_names[] = {
+    [TOKEN_KIND_NONE] = "NONE",
+    [TOKEN_KIND_LITERAL] = "LITERAL",
+    [TOKEN_KIND_OPERATOR] = "OPERATOR",
+    [TOKEN_KIND_GROUP] = "GROUP",
+    [TOKEN_KIND_IDENTIFIER] = "IDENTIFIER",
+};
+
+static const char* const token_role_names[TOKEN_DESCRIPTOR_ROLES] = {
+    [TOKEN_ROLE_NONE] = "NONE",
+    [TOKEN_ROLE_UNARY] = "UNARY",
+    [TOKEN_ROLE_BINARY] = "BINARY",
+};
+
+static const char* const token_associate_names[] = {
+    [TOKEN_ASSOCIATE_NONE] = "NONE",
+    [TOKEN_ASSOCIATE_LEFT] = "LEFT",
+    [TOKEN_ASSOCIATE_RIGHT] = "RIGHT",
+};
+
+// Offset by one so TOKEN_PRECEDENT_ERROR (-1) lands at index 0
+static const char* const token_precedent_names[] = {
+    [TOKEN_PRECEDENT_ERROR + 1] = "ERROR",
+    [TOKEN_PRECEDENT_NONE + 1] = "NONE",
+    [TOKEN_PRECEDENT_ADDITIVE + 1] = "ADDITIVE",
+    [TOKEN_PRECEDENT_MULTIPLICATIVE + 1] = "MULTIPLICATIVE",
+    [TOKEN_PRECEDENT_UNARY + 1] = "UNARY",
+    [TOKEN_PRECEDENT_POWER + 1] = "POWER",
+};
+
 const char* token_type_to_string(const Token* token) {
     if (!token) {
         return "NULL";
     }
-    switch (token->type) {
-        case TOKEN_TYPE_NONE:
-            return "NONE";
-        case TOKEN_TYPE_INTEGER:
-            return "INTEGER";
-        case TOKEN_TYPE_FLOAT:
-            return "FLOAT";
-        case TOKEN_TYPE_PLUS:
-            return "PLUS";
-        case TOKEN_TYPE_MINUS:
-            return "MINUS";
-        case TOKEN_TYPE_STAR:
-            return "STAR";
-        case TOKEN_TYPE_SLASH:
-            return "SLASH";
-        case TOKEN_TYPE_MOD:
-            return "MOD";
-        case TOKEN_TYPE_LEFT_PAREN:
-            return "LEFT_PAREN";
-        case TOKEN_TYPE_RIGHT_PAREN:
-            return "RIGHT_PAREN";
-        default:
-            return "UNKNOWN";
-    }
+
+    const char* name = token->type < TOKEN_DESCRIPTOR_TYPES ? token_type_names[token->type] : NULL;
+    return name ? name : "UNKNOWN";
 }
 
 const char* token_kind_to_string(const Token* token) {
-    if (!token) {
-        return "NULL";
-    }
-    switch (token->kind) {
-        case TOKEN_KIND_NONE:
-            return "NONE";
-        case TOKEN_KIND_LITERAL:
-            return "LITERAL";
-        case TOKEN_KIND_OPERATOR:
-            return "OPERATOR";
-        case TOKEN_KIND_GROUP:
-            return "GROUP";
-        default:
-            return "UNKNOWN";
-    }
+    return token ? token_kind_names[token_kind(token)] : "NULL";
 }
 
 const char* token_role_to_string(const Token* token) {
@@ -416,52 +856,24 @@ const char* token_role_to_string(const Token* token) {
         return "NULL";
     }
 
-    switch (token->role) {
-        case TOKEN_ROLE_NONE:
-            return "NONE";
-        case TOKEN_ROLE_UNARY:
-            return "UNARY";
-        case TOKEN_ROLE_BINARY:
-            return "BINARY";
-        default:
-            return "UNKNOWN";
-    }
+    const char* name = token->role < TOKEN_DESCRIPTOR_ROLES ? token_role_names[token->role] : NULL;
+    return name ? name : "UNKNOWN";
 }
 
 const char* token_associate_to_string(const Token* token) {
     if (!token) {
         return "NULL";
     }
-    switch (token->association) {
-        case TOKEN_ASSOCIATE_NONE:
-            return "NONE";
-        case TOKEN_ASSOCIATE_LEFT:
-            return "LEFT";
-        case TOKEN_ASSOCIATE_RIGHT:
-            return "RIGHT";
-        default:
-            return "UNKNOWN";
-    }
+
+    return token_associate_names[token_descriptor(token->type, token->role)->association];
 }
 
 const char* token_precedent_to_string(const Token* token) {
     if (!token) {
         return "NULL";
     }
-    switch (token->precedence) {
-        case TOKEN_PRECEDENT_ERROR:
-            return "ERROR";
-        case TOKEN_PRECEDENT_NONE:
-            return "NONE";
-        case TOKEN_PRECEDENT_ADDITIVE:
-            return "ADDITIVE";
-        case TOKEN_PRECEDENT_MULTIPLICATIVE:
-            return "MULTIPLICATIVE";
-        case TOKEN_PRECEDENT_UNARY:
-            return "UNARY";
-        default:
-            return "UNKNOWN";
-    }
+
+    return token_precedent_names[token_descriptor(token->type, token->role)->precedence + 1];
 }
 
 void token_dump(const Token* token) {
@@ -470,7 +882,8 @@ void token_dump(const Token* token) {
     }
 
     printf(
-        "[Token] lexeme='%s', size=%zu, type=%s, kind=%s, role=%s, assoc=%s, prec=%s\n",
+        "[Token] lexeme='%.*s', size=%zu, type=%s, kind=%s, role=%s, assoc=%s, prec=%s\n",
+        (int) token->size,
         token->lexeme,
         token->size,
         token_type_to_string(token),
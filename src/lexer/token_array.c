@@ -0,0 +1,231 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file src/lexer/token_array.c
+ * @brief Packed, value-based token storage for arithmetic expressions.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "lexer/token_array.h"
+
+// --- Token Tag ---
+
+Precedent token_tag_precedence(TokenTag tag) {
+    return (Precedent) token_descriptor(token_tag_type(tag), token_tag_role(tag))->precedence;
+}
+
+Associate token_tag_associate(TokenTag tag) {
+    return (Associate) token_descriptor(token_tag_type(tag), token_tag_role(tag))->association;
+}
+
+TokenKind token_tag_kind(TokenTag tag) {
+    return (TokenKind) token_descriptor(token_tag_type(tag), token_tag_role(tag))->kind;
+}
+
+// --- Token Array Operations ---
+
+TokenArray* token_array_create(const char* source) {
+    TokenArray* array = malloc(sizeof(TokenArray));
+    if (!array) {
+        return NULL;
+    }
+
+    array->count = 0;
+    array->capacity = 0;
+    array->source = source;
+    array->text = NULL;
+    array->tags = NULL;
+    array->offsets = NULL;
+    array->sizes = NULL;
+
+    if (!token_array_reserve(array, 1)) {
+        token_array_free(array);
+        return NULL;
+    }
+
+    return array;
+}
+
+void token_array_free(TokenArray* array) {
+    if (array) {
+        free(array->text);
+        free(array->tags);
+        free(array->offsets);
+        free(array->sizes);
+        free(array);
+    }
+}
+
+bool token_array_is_empty(const TokenArray* array) {
+    return array && array->count == 0;
+}
+
+bool token_array_reserve(TokenArray* array, size_t capacity) {
+    if (!array) {
+        return false;
+    }
+
+    if (capacity <= array->capacity) {
+        return true;
+    }
+
+    TokenTag* tags = realloc(array->tags, sizeof(TokenTag) * capacity);
+    if (!tags) {
+        return false;
+    }
+    array->tags = tags;
+
+    uint32_t* offsets = realloc(array->offsets, sizeof(uint32_t) * capacity);
+    if (!offsets) {
+        return false;
+    }
+    array->offsets = offsets;
+
+    uint32_t* sizes = realloc(array->sizes, sizeof(uint32_t) * capacity);
+    if (!sizes) {
+        return false;
+    }
+    array->sizes = sizes;
+
+    array->capacity = capacity;
+    return true;
+}
+
+bool token_array_push(TokenArray* array, TokenTag tag, uint32_t offset, uint32_t size) {
+    if (!array) {
+        return false;
+    }
+
+    if (array->count >= array->capacity) {
+        if (!token_array_reserve(array, array->capacity ? array->capacity * 2 : 8)) {
+            return false;
+        }
+    }
+
+    array->tags[array->count] = tag;
+    array->offsets[array->count] = offset;
+    array->sizes[array->count] = size;
+    array->count++;
+    return true;
+}
+
+const char* token_array_lexeme(const TokenArray* array, size_t index) {
+    if (!array || !array->source || index >= array->count) {
+        return NULL;
+    }
+
+    return array->source + array->offsets[index];
+}
+
+// --- Token List Migration ---
+
+TokenArray* token_array_from_list(const TokenList* list) {
+    if (!list || !list->tokens) {
+        return NULL;
+    }
+
+    size_t length = 0;
+    for (size_t i = 0; i < list->count; i++) {
+        length += list->tokens[i]->size;
+    }
+    if (length > UINT32_MAX) {
+        return NULL;
+    }
+
+    TokenArray* array = token_array_create(NULL);
+    if (!array) {
+        return NULL;
+    }
+
+    array->text = malloc(length + 1);
+    if (!array->text || !token_array_reserve(array, list->count)) {
+        token_array_free(array);
+        return NULL;
+    }
+    array->source = array->text;
+
+    size_t offset = 0;
+    for (size_t i = 0; i < list->count; i++) {
+        const Token* token = list->tokens[i];
+        memcpy(array->text + offset, token->lexeme, token->size);
+        token_array_push(
+            array,
+            token_tag_pack(token->type, token->role),
+            (uint32_t) offset,
+            (uint32_t) token->size
+        );
+        offset += token->size;
+    }
+    array->text[offset] = '\0';
+
+    return array;
+}
+
+TokenList* token_array_to_list(const TokenArray* array) {
+    if (!array || !array->source) {
+        return NULL;
+    }
+
+    TokenList* list = token_list_create_with_capacity(array->count);
+    if (!list) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < array->count; i++) {
+        const TokenTag tag = array->tags[i];
+        // Typed creation decodes literals, as the lexer does
+        Token* token = token_create_typed(
+            NULL, token_array_lexeme(array, i), array->sizes[i], token_tag_type(tag), true
+        );
+        if (!token) {
+            token_list_free(list);
+            return NULL;
+        }
+
+        token->role = token_tag_role(tag);
+
+        bool pushed = token_list_push(list, token);
+        token_free(token);
+        if (!pushed) {
+            token_list_free(list);
+            return NULL;
+        }
+    }
+
+    return list;
+}
+
+void token_array_dump(const TokenArray* array) {
+    if (!array || token_array_is_empty(array)) {
+        return;
+    }
+
+    for (size_t i = 0; i < array->count; i++) {
+        // Borrow the token string tables through a stack token built from the tag
+        const TokenTag tag = array->tags[i];
+        const Token token = {
+            .lexeme = token_array_lexeme(array, i),
+            .size = array->sizes[i],
+            .type = token_tag_type(tag),
+            .role = token_tag_role(tag),
+            .view = true,
+        };
+
+        printf(
+            "[TokenArray] i=%zu, lexeme='%.*s', size=%zu, type=%s, kind=%s, role=%s, assoc=%s, "
+            "prec=%s\n",
+            i,
+            (int) token.size,
+            token.lexeme,
+            token.size,
+            token_type_to_string(&token),
+            token_kind_to_string(&token),
+            token_role_to_string(&token),
+            token_associate_to_string(&token),
+            token_precedent_to_string(&token)
+        );
+    }
+}
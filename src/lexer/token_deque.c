@@ -0,0 +1,222 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file src/lexer/token_deque.c
+ * @brief Ring-buffer deque of tokens with O(1) push and pop at both ends.
+ * @warning Ownership Model (move semantics, nothing is cloned):
+ *     - If you push it, the deque owns it.
+ *     - If you pop it, you own it.
+ *     - If you free the deque, it kills whatever is left.
+ *     - Arena-backed deques never free tokens; the arena reclaims them on reset.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "lexer/token_deque.h"
+
+#define TOKEN_DEQUE_CAPACITY 8 // Initial slots (power of two)
+
+static size_t token_deque_slot(const TokenDeque* deque, size_t index) {
+    return (deque->head + index) & (deque->capacity - 1);
+}
+
+/// @brief Doubles the ring, unwrapping it so the front lands back at slot 0.
+static bool token_deque_grow(TokenDeque* deque) {
+    size_t capacity = deque->capacity * 2;
+    Token** tokens = malloc(sizeof(Token*) * capacity);
+    if (!tokens) {
+        return false;
+    }
+
+    size_t first = deque->capacity - deque->head; // slots before the wrap
+    if (first > deque->count) {
+        first = deque->count;
+    }
+    memcpy(tokens, deque->tokens + deque->head, sizeof(Token*) * first);
+    memcpy(tokens + first, deque->tokens, sizeof(Token*) * (deque->count - first));
+
+    free(deque->tokens);
+    deque->tokens = tokens;
+    deque->capacity = capacity;
+    deque->head = 0;
+    return true;
+}
+
+// --- Token Deque Lifecycle ---
+
+TokenDeque* token_deque_create(void) {
+    TokenDeque* deque = malloc(sizeof(TokenDeque));
+    if (!deque) {
+        return NULL;
+    }
+
+    deque->tokens = malloc(sizeof(Token*) * TOKEN_DEQUE_CAPACITY);
+    if (!deque->tokens) {
+        free(deque);
+        return NULL;
+    }
+
+    deque->head = 0;
+    deque->count = 0;
+    deque->capacity = TOKEN_DEQUE_CAPACITY;
+    deque->arena = NULL;
+    return deque;
+}
+
+TokenDeque* token_deque_create_arena(Arena* arena) {
+    if (!arena) {
+        return NULL;
+    }
+
+    TokenDeque* deque = token_deque_create();
+    if (!deque) {
+        return NULL;
+    }
+
+    deque->arena = arena;
+    return deque;
+}
+
+void token_deque_clear(TokenDeque* deque) {
+    if (!deque) {
+        return;
+    }
+
+    for (size_t i = 0; !deque->arena && i < deque->count; i++) {
+        token_free(deque->tokens[token_deque_slot(deque, i)]);
+    }
+    deque->head = 0;
+    deque->count = 0;
+}
+
+void token_deque_free(TokenDeque* deque) {
+    if (deque) {
+        token_deque_clear(deque);
+        free(deque->tokens);
+        free(deque);
+    }
+}
+
+TokenDeque* token_deque_from_list(TokenList* list) {
+    if (!list || !list->tokens) {
+        return NULL;
+    }
+
+    TokenDeque* deque = malloc(sizeof(TokenDeque));
+    if (!deque) {
+        return NULL;
+    }
+
+    size_t capacity = TOKEN_DEQUE_CAPACITY;
+    while (capacity < list->count) {
+        capacity *= 2;
+    }
+
+    deque->tokens = malloc(sizeof(Token*) * capacity);
+    if (!deque->tokens) {
+        free(deque);
+        return NULL;
+    }
+
+    // The pointers move across; the list forgets them so nothing is freed twice
+    memcpy(deque->tokens, list->tokens, sizeof(Token*) * list->count);
+    deque->head = 0;
+    deque->count = list->count;
+    deque->capacity = capacity;
+    deque->arena = list->arena;
+    list->count = 0;
+    return deque;
+}
+
+// --- Token Deque Operations ---
+
+bool token_deque_is_empty(const TokenDeque* deque) {
+    return !deque || deque->count == 0;
+}
+
+bool token_deque_push_back(TokenDeque* deque, Token* token) {
+    if (!deque || !token) {
+        return false;
+    }
+
+    if (deque->count == deque->capacity && !token_deque_grow(deque)) {
+        return false;
+    }
+
+    deque->tokens[token_deque_slot(deque, deque->count++)] = token;
+    return true;
+}
+
+bool token_deque_push_front(TokenDeque* deque, Token* token) {
+    if (!deque || !token) {
+        return false;
+    }
+
+    if (deque->count == deque->capacity && !token_deque_grow(deque)) {
+        return false;
+    }
+
+    deque->head = (deque->head - 1) & (deque->capacity - 1);
+    deque->tokens[deque->head] = token;
+    deque->count++;
+    return true;
+}
+
+Token* token_deque_pop_front(TokenDeque* deque) {
+    if (token_deque_is_empty(deque)) {
+        return NULL;
+    }
+
+    Token* token = deque->tokens[deque->head];
+    deque->head = token_deque_slot(deque, 1);
+    deque->count--;
+    return token;
+}
+
+Token* token_deque_pop_back(TokenDeque* deque) {
+    if (token_deque_is_empty(deque)) {
+        return NULL;
+    }
+
+    deque->count--;
+    return deque->tokens[token_deque_slot(deque, deque->count)];
+}
+
+const Token* token_deque_peek_front(const TokenDeque* deque) {
+    return token_deque_is_empty(deque) ? NULL : deque->tokens[deque->head];
+}
+
+const Token* token_deque_peek_back(const TokenDeque* deque) {
+    return token_deque_is_empty(deque) ? NULL
+                                       : deque->tokens[token_deque_slot(deque, deque->count - 1)];
+}
+
+const Token* token_deque_peek_index(const TokenDeque* deque, size_t index) {
+    if (!deque || index >= deque->count) {
+        return NULL;
+    }
+
+    return deque->tokens[token_deque_slot(deque, index)];
+}
+
+void token_deque_dump(const TokenDeque* deque) {
+    if (token_deque_is_empty(deque)) {
+        return;
+    }
+
+    for (size_t i = 0; i < deque->count; i++) {
+        const Token* token = token_deque_peek_index(deque, i);
+        printf(
+            "[TokenDeque] i=%zu, lexeme='%.*s', size=%zu, type=%s, kind=%s, role=%s\n",
+            i,
+            (int) token->size,
+            token->lexeme,
+            token->size,
+            token_type_to_string(token),
+            token_kind_to_string(token),
+            token_role_to_string(token)
+        );
+    }
+}
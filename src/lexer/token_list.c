@@ -8,35 +8,63 @@
  *     - If you pop it, you own it.
  *     - If you push it, you clone it.
  *     - If you free it, you kill it.
+ *     - If you move it (push_move / pop_move), the pointer changes hands without a clone.
+ *     - Arena-backed lists borrow: push stores the pointer, pop hands it back, and the arena
+ *       reclaims every token on reset.
  * @ref https://www.gingerbill.org/article/2020/06/21/the-ownership-semantics-flaw/
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <stdio.h>
 
 #include "lexer/token_list.h"
+#include "stats.h"
 
 TokenList* token_list_create(void) {
+    return token_list_create_with_capacity(1);
+}
+
+TokenList* token_list_create_with_capacity(size_t capacity) {
+    if (capacity == 0) {
+        capacity = 1;
+    }
+
     TokenList* list = malloc(sizeof(TokenList));
     if (!list) {
         return NULL;
     }
 
-    list->tokens = malloc(sizeof(Token*));
+    list->tokens = malloc(sizeof(Token*) * capacity);
     if (!list->tokens) {
         free(list);
         return NULL;
     }
 
-    list->capacity = 1;
+    list->capacity = capacity;
     list->count = 0;
+    list->arena = NULL;
+    return list;
+}
+
+TokenList* token_list_create_arena(Arena* arena) {
+    if (!arena) {
+        return NULL;
+    }
+
+    TokenList* list = token_list_create();
+    if (!list) {
+        return NULL;
+    }
+
+    list->arena = arena;
     return list;
 }
 
 void token_list_free(TokenList* list) {
     if (list) {
         if (list->tokens) {
-            for (size_t i = 0; i < list->count; i++) {
+            for (size_t i = 0; !list->arena && i < list->count; i++) {
                 if (list->tokens[i]) {
                     token_free(list->tokens[i]);
                 }
@@ -47,6 +75,35 @@ void token_list_free(TokenList* list) {
     }
 }
 
+void token_list_clear(TokenList* list) {
+    if (!list || !list->tokens) {
+        return;
+    }
+
+    for (size_t i = 0; !list->arena && i < list->count; i++) {
+        token_free(list->tokens[i]);
+    }
+    list->count = 0;
+}
+
+bool token_list_reserve(TokenList* list, size_t capacity) {
+    if (!list || !list->tokens) {
+        return false;
+    }
+
+    if (capacity <= list->capacity) {
+        return true;
+    }
+
+    Token** temp = realloc(list->tokens, sizeof(Token*) * capacity);
+    if (!temp) {
+        return false;
+    }
+    list->tokens = temp;
+    list->capacity = capacity;
+    return true;
+}
+
 bool token_list_is_empty(const TokenList* list) {
     return list && list->tokens && list->count == 0;
 }
@@ -55,22 +112,46 @@ bool token_list_is_full(const TokenList* list) {
     return list && list->tokens && list->count >= list->capacity;
 }
 
+static bool token_list_grow(TokenList* list) {
+    size_t capacity = list->capacity * 2;
+    Token** temp = realloc(list->tokens, sizeof(Token*) * capacity);
+    if (!temp) {
+        return false;
+    }
+    list->tokens = temp;
+    list->capacity = capacity;
+    SHUNT_STAT_INC(SHUNT_STAT_LIST_GROWS);
+    return true;
+}
+
 bool token_list_push(TokenList* list, const Token* token) {
     if (!list || !list->tokens || !token) {
         return false;
     }
 
-    if (token_list_is_full(list)) {
-        size_t capacity = list->capacity * 2;
-        Token** temp = realloc(list->tokens, sizeof(Token*) * capacity);
-        if (!temp) {
-            return false;
-        }
-        list->tokens = temp;
-        list->capacity = capacity;
+    if (token_list_is_full(list) && !token_list_grow(list)) {
+        return false;
+    }
+
+    Token* entry = list->arena ? (Token*) token : token_clone(token);
+    if (!entry) {
+        return false;
+    }
+
+    list->tokens[list->count++] = entry;
+    return true;
+}
+
+bool token_list_push_move(TokenList* list, Token* token) {
+    if (!list || !list->tokens || !token) {
+        return false;
+    }
+
+    if (token_list_is_full(list) && !token_list_grow(list)) {
+        return false;
     }
 
-    list->tokens[list->count++] = token_clone(token);
+    list->tokens[list->count++] = token;
     return true;
 }
 
@@ -84,13 +165,27 @@ Token* token_list_pop(TokenList* list) {
         return NULL;
     }
 
-    Token* clone = token_clone(token);
     list->tokens[list->count - 1] = NULL;
     list->count--;
+    if (list->arena) {
+        return token;
+    }
+
+    Token* clone = token_clone(token);
     token_free(token);
     return clone;
 }
 
+Token* token_list_pop_move(TokenList* list) {
+    if (!list || !list->tokens || token_list_is_empty(list)) {
+        return NULL;
+    }
+
+    Token* token = list->tokens[--list->count];
+    list->tokens[list->count] = NULL;
+    return token;
+}
+
 Token* token_list_pop_index(TokenList* list, int64_t index) {
     if (!list || !list->tokens || token_list_is_empty(list)) {
         return NULL;
@@ -109,15 +204,18 @@ Token* token_list_pop_index(TokenList* list, int64_t index) {
         return NULL;
     }
 
-    list->tokens[(size_t) index] = NULL;
-    Token* clone = token_clone(token);
-
-    // Shift elements left
+    // Close the gap in one block move (the old element-wise loop dropped the last token)
+    size_t slot = (size_t) index;
+    size_t tail = list->count - slot - 1;
+    memmove(&list->tokens[slot], &list->tokens[slot + 1], sizeof(Token*) * tail);
     list->count--;
-    for (size_t i = index; i < list->count - 1; ++i) {
-        list->tokens[i] = list->tokens[i + 1];
+    list->tokens[list->count] = NULL;
+
+    if (list->arena) {
+        return token;
     }
 
+    Token* clone = token_clone(token);
     token_free(token);
     return clone;
 }
@@ -150,9 +248,10 @@ void token_list_dump(const TokenList* list) {
     for (size_t i = 0; i < list->count; i++) {
         Token* token = list->tokens[i];
         printf(
-            "[TokenList] i=%zu, lexeme='%s', size=%zu, type=%s, kind=%s, role=%s, assoc=%s, "
+            "[TokenList] i=%zu, lexeme='%.*s', size=%zu, type=%s, kind=%s, role=%s, assoc=%s, "
             "prec=%s\n",
             i,
+            (int) token->size,
             token->lexeme,
             token->size,
             token_type_to_string(token),
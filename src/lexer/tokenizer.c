@@ -3,43 +3,232 @@
  * @brief Core Token Generator used in lexical analysis.
  */
 
-#include <ctype.h>
+#include <string.h>
 
 #include "lexer/tokenizer.h"
+#include "stats.h"
 
-TokenList* tokenizer(const char* expression) {
-    TokenList* list = token_list_create();
+#if defined(TOKEN_SCAN_SSE2)
+    #include <emmintrin.h>
+#endif
 
-    while (*expression) {
-        Token* token = NULL;
+// --- Lexer ---
+
+void lexer_init(Lexer* lexer, const char* source, size_t length, Arena* arena, bool view) {
+    lexer->source = source;
+    lexer->length = length;
+    lexer->offset = 0;
+    lexer->arena = arena;
+    lexer->view = view;
+    lexer->error = (ShuntError) {.code = SHUNT_STATUS_OK};
+}
+
+/// @brief Offset of the first non-whitespace byte at or after offset.
+/// @note The SSE2 path tests 16 bytes per step for ' ' or '\t'..'\r' and never loads past length.
+static size_t lexer_skip_space(const char* source, size_t offset, size_t length) {
+#if defined(TOKEN_SCAN_SSE2)
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i lower = _mm_set1_epi8('\t' - 1);
+    const __m128i upper = _mm_set1_epi8('\r' + 1);
+    while (length - offset >= 16) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i*) (source + offset));
+        const __m128i is_space = _mm_or_si128(
+            _mm_cmpeq_epi8(chunk, space),
+            _mm_and_si128(_mm_cmpgt_epi8(chunk, lower), _mm_cmplt_epi8(chunk, upper))
+        );
+        const unsigned mask = (unsigned) _mm_movemask_epi8(is_space);
+        if (mask != 0xFFFF) {
+            return offset + (size_t) __builtin_ctz(~mask);
+        }
+        offset += 16;
+    }
+#endif
+
+    while (offset < length && token_char_class(source[offset]) == TOKEN_CHAR_SPACE) {
+        offset++;
+    }
+    return offset;
+}
+
+bool lexer_scan(Lexer* lexer, TokenType* type, size_t* offset, size_t* size) {
+    const char* source = lexer->source;
+
+    lexer->offset = lexer_skip_space(source, lexer->offset, lexer->length);
+
+    *offset = lexer->offset;
+    if (lexer->offset >= lexer->length || source[lexer->offset] == '\0') {
+        *type = TOKEN_TYPE_NONE;
+        *size = 0;
+        return true; // end of input
+    }
+
+    const char* cursor = source + lexer->offset;
+    const size_t remaining = lexer->length - lexer->offset;
+
+    // One table lookup decides the token class and, for symbols, the concrete type
+    switch (token_char_class(*cursor)) {
+        case TOKEN_CHAR_DIGIT:
+            *size = token_scan_number(cursor, remaining, type);
+            break;
+        case TOKEN_CHAR_IDENT:
+            *type = TOKEN_TYPE_IDENTIFIER;
+            *size = token_scan_identifier(cursor, remaining);
+            break;
+        case TOKEN_CHAR_SYMBOL:
+            *size = token_scan_symbol(cursor, remaining, type);
+            break;
+        default:
+            *type = TOKEN_TYPE_NONE;
+            *size = 0;
+            shunt_error_set(&lexer->error, SHUNT_STATUS_SYNTAX, TOKEN_TYPE_NONE, lexer->offset, 1);
+            return false; // unknown character encountered
+    }
+
+    lexer->offset += *size; // advance the stream
+    return true;
+}
+
+bool lexer_next(Lexer* lexer, Token** token) {
+    TokenType type;
+    size_t offset;
+    size_t size;
+
+    *token = NULL;
+    if (!lexer_scan(lexer, &type, &offset, &size)) {
+        return false;
+    }
+
+    if (size == 0) {
+        return true; // end of input
+    }
+
+    *token = token_create_typed(lexer->arena, lexer->source + offset, size, type, lexer->view);
+    if (!*token) {
+        shunt_error_set(&lexer->error, SHUNT_STATUS_MEMORY, type, offset, size);
+        return false;
+    }
+    return true;
+}
+
+// --- Tokenizer ---
+
+TokenList* tokenizer_checked(
+    const char* expression, size_t length, Arena* arena, bool view, ShuntError* error
+) {
+    shunt_error_set(error, SHUNT_STATUS_OK, TOKEN_TYPE_NONE, 0, 0);
+    if (!expression) {
+        shunt_error_set(error, SHUNT_STATUS_EMPTY, TOKEN_TYPE_NONE, 0, 0);
+        return NULL;
+    }
+
+    // A NULL arena produces heap tokens owned by the returned list
+    const size_t capacity = tokenizer_capacity_hint(length);
+    TokenList* list = arena ? token_list_create_arena(arena)
+                            : token_list_create_with_capacity(capacity);
+    if (!list || !token_list_reserve(list, capacity)) {
+        token_list_free(list);
+        shunt_error_set(error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, 0, 0);
+        return NULL;
+    }
 
-        if (isdigit(*expression)) {
-            token = token_create_number(expression);
-        } else if (isop(*expression)) {
-            token = token_create_operator(expression);
-        } else if (isgroup(*expression)) {
-            token = token_create_group(expression);
-        } else if (isspace(*expression)) {
-            expression++; // ignore all whitespace
-            continue;
-        } else {
-            token_list_free(list); // unknown character encountered
+    SHUNT_TRACE_BEGIN(SHUNT_TRACE_TOKENIZE, length);
+    Lexer lexer;
+    lexer_init(&lexer, expression, length, arena, view);
+
+    while (true) {
+        Token* token = NULL;
+        if (!lexer_next(&lexer, &token)) {
+            if (error) {
+                *error = lexer.error;
+            }
+            token_list_free(list);
+            SHUNT_TRACE_END(SHUNT_TRACE_TOKENIZE, 0);
             return NULL;
         }
 
         if (!token) {
+            break; // end of input
+        }
+
+        // Arena lists borrow the token; heap lists take ownership of the freshly lexed one
+        const TokenType type = token->type;
+        const size_t size = token->size;
+        bool pushed = arena ? token_list_push(list, token) : token_list_push_move(list, token);
+        if (!pushed) {
+            if (!arena) {
+                token_free(token); // still ours: the move failed
+            }
+            shunt_error_set(error, SHUNT_STATUS_MEMORY, type, lexer.offset - size, size);
             token_list_free(list);
+            SHUNT_TRACE_END(SHUNT_TRACE_TOKENIZE, 0);
             return NULL;
         }
+    }
 
-        if (!token_list_push(list, token)) {
-            token_list_free(list);
+    SHUNT_STAT_ADD(SHUNT_STAT_TOKENS_LEXED, list->count);
+    SHUNT_TRACE_END(SHUNT_TRACE_TOKENIZE, list->count);
+    return list;
+}
+
+static TokenList* tokenize(const char* expression, Arena* arena, bool view) {
+    return expression ? tokenizer_checked(expression, strlen(expression), arena, view, NULL) : NULL;
+}
+
+TokenList* tokenizer(const char* expression) {
+    return tokenize(expression, NULL, false);
+}
+
+TokenList* tokenizer_arena(const char* expression, Arena* arena) {
+    return arena ? tokenize(expression, arena, false) : NULL;
+}
+
+TokenList* tokenizer_view(const char* expression, Arena* arena) {
+    return tokenize(expression, arena, true);
+}
+
+TokenArray* tokenizer_array(const char* expression) {
+    if (!expression) {
+        return NULL;
+    }
+
+    const size_t length = strlen(expression);
+    if (length > UINT32_MAX) {
+        return NULL;
+    }
+
+    TokenArray* array = token_array_create(expression);
+    if (!array || !token_array_reserve(array, tokenizer_capacity_hint(length))) {
+        token_array_free(array);
+        return NULL;
+    }
+
+    SHUNT_TRACE_BEGIN(SHUNT_TRACE_TOKENIZE, length);
+    Lexer lexer;
+    lexer_init(&lexer, expression, length, NULL, true);
+
+    while (true) {
+        TokenType type;
+        size_t offset;
+        size_t size;
+
+        if (!lexer_scan(&lexer, &type, &offset, &size)) {
+            token_array_free(array);
+            SHUNT_TRACE_END(SHUNT_TRACE_TOKENIZE, 0);
             return NULL;
         }
 
-        expression += token->size; // advance the stream
-        token_free(token); // free the cloned token after pushing it to the list
+        if (size == 0) {
+            break; // end of input
+        }
+
+        if (!token_array_push(array, token_tag_lexed(type), (uint32_t) offset, (uint32_t) size)) {
+            token_array_free(array);
+            SHUNT_TRACE_END(SHUNT_TRACE_TOKENIZE, 0);
+            return NULL;
+        }
     }
 
-    return list;
+    SHUNT_STAT_ADD(SHUNT_STAT_TOKENS_LEXED, array->count);
+    SHUNT_TRACE_END(SHUNT_TRACE_TOKENIZE, array->count);
+    return array;
 }
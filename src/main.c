@@ -4,21 +4,40 @@
  * @file src/main.c
  * @brief The shunting yard algorithm completely from scratch in pure C.
  *
+ * Usage:
+ *     ./build/rpn                      Run the built-in sample expression
+ *     ./build/rpn "<expression>"       Print the postfix form and its value (left out if the
+ *                                      expression has variables; faults such as 1 / 0 fail)
+ *     ./build/rpn --stream [file|-]    Convert one expression per line to postfix
+ *     ./build/rpn --mmap file          Same as --stream, lexing straight out of a read-only mapping
+ *     ./build/rpn --compile file out   Compile one expression per line into a bytecode image
+ *     ./build/rpn --run file           Evaluate every program of an image file, mapped in place
+ *
  * @ref https://en.wikipedia.org/wiki/Shunting_yard_algorithm
  * @ref https://mathcenter.oxford.emory.edu/site/cs171/shuntingYardAlgorithm/
  */
 
 #include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "lexer/token.h"
 #include "lexer/token_list.h"
 #include "lexer/tokenizer.h"
 #include "parser.h"
+#include "evaluator.h"
+#include "bytecode.h"
+#include "stream.h"
 
-// === Main ===
+// === Sample ===
 
-int main(void) {
+static int rpn_sample(void) {
     const char* expression = "(((53 + 2) - (-5. ** 4)) / 5) % 100";
     printf("[DEBUG] [INFIX] %s\n", expression);
 
@@ -29,10 +48,455 @@ int main(void) {
     printf("[DEBUG] [POSTFIX] %s\n", shunt_is_valid_postfix(postfix) ? "\u2705" : "\u274C");
 
     token_list_dump(postfix);
+
+    RpnValue result;
+    if (rpn_evaluate(postfix, &result)) {
+        rpn_value_dump(&result);
+    }
+
     token_list_free(postfix);
     token_list_free(infix);
 
     return 0;
 }
 
+// === Buffered Writer ===
+
+#define RPN_WRITER_SIZE (1u << 20) // Bytes buffered before each write()
+
+/// @brief Collects output in one large buffer and hands it to write() in big blocks, bypassing
+///        per-token stdio calls.
+typedef struct RpnWriter {
+    int fd;
+    size_t used;
+    bool error; // A write() failed; further output is dropped
+    char buffer[RPN_WRITER_SIZE];
+} RpnWriter;
+
+static RpnWriter rpn_writer = {.fd = STDOUT_FILENO};
+
+static void rpn_writer_flush(RpnWriter* writer) {
+    size_t offset = 0;
+    while (!writer->error && offset < writer->used) {
+        ssize_t size = write(writer->fd, writer->buffer + offset, writer->used - offset);
+        if (size > 0) {
+            offset += (size_t) size;
+        } else if (size < 0 && errno != EINTR) {
+            writer->error = true;
+        }
+    }
+    writer->used = 0;
+}
+
+static void rpn_writer_put(RpnWriter* writer, const char* data, size_t size) {
+    if (size > RPN_WRITER_SIZE - writer->used) {
+        rpn_writer_flush(writer);
+        if (size > RPN_WRITER_SIZE) {
+            // Larger than the whole buffer: pass it straight through
+            while (!writer->error && size > 0) {
+                ssize_t written = write(writer->fd, data, size);
+                if (written > 0) {
+                    data += written;
+                    size -= (size_t) written;
+                } else if (written < 0 && errno != EINTR) {
+                    writer->error = true;
+                }
+            }
+            return;
+        }
+    }
+
+    memcpy(writer->buffer + writer->used, data, size);
+    writer->used += size;
+}
+
+static void rpn_writer_putc(RpnWriter* writer, char c) {
+    if (writer->used == RPN_WRITER_SIZE) {
+        rpn_writer_flush(writer);
+    }
+    writer->buffer[writer->used++] = c;
+}
+
+// === Postfix Output ===
+
+/// @brief Writes the postfix tokens space-separated. Unary operators are prefixed with 'u' so the
+///        output stays unambiguous (e.g. "-5 - 3" becomes "5 u- 3 -").
+static void rpn_write_postfix(RpnWriter* writer, const TokenList* postfix) {
+    for (size_t i = 0; i < postfix->count; i++) {
+        const Token* token = postfix->tokens[i];
+        if (i > 0) {
+            rpn_writer_putc(writer, ' ');
+        }
+        if (token_is_role_unary(token)) {
+            rpn_writer_putc(writer, 'u');
+        }
+        rpn_writer_put(writer, token->lexeme, token->size);
+    }
+    rpn_writer_putc(writer, '\n');
+}
+
+// === Expression ===
+
+/// @brief Unbound variables are the one evaluation failure that is not an error: there is no value.
+static bool rpn_has_variables(const TokenList* postfix) {
+    for (size_t i = 0; i < postfix->count; i++) {
+        if (token_is_type_identifier(postfix->tokens[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Explains why a well-formed expression without variables has no value.
+static void rpn_report_fault(const TokenList* postfix, const char* expression) {
+    const Token* literal = bytecode_range_fault(postfix);
+    if (literal) {
+        fprintf(
+            stderr,
+            "[ERROR] column %zu: %s: %s\n",
+            (size_t) (literal->lexeme - expression) + 1, // lexemes are views
+            shunt_status_to_string(SHUNT_STATUS_RANGE),
+            expression
+        );
+    } else {
+        fprintf(stderr, "[ERROR] division by zero: %s\n", expression);
+    }
+}
+
+static int rpn_expression(const char* expression) {
+    const size_t length = strlen(expression);
+    ShuntError error;
+    TokenList* postfix = shunt_expression_validated(expression, length, NULL, NULL, &error);
+    if (!postfix) {
+        fprintf(
+            stderr,
+            "[ERROR] column %zu: %s: %s\n",
+            error.column + 1,
+            shunt_status_to_string(error.code),
+            expression
+        );
+        token_list_free(postfix);
+        return 2;
+    }
+
+    rpn_write_postfix(&rpn_writer, postfix);
+
+    RpnValue result;
+    int status = 0;
+    if (rpn_evaluate(postfix, &result)) {
+        char value[64];
+        int size = result.type == TOKEN_TYPE_INTEGER
+                       ? snprintf(value, sizeof(value), "%lld\n", (long long) result.integer)
+                       : snprintf(value, sizeof(value), "%.17g\n", result.real);
+        rpn_writer_put(&rpn_writer, value, (size_t) size);
+    } else if (!rpn_has_variables(postfix)) {
+        rpn_writer_flush(&rpn_writer); // keep the postfix ahead of the report
+        rpn_report_fault(postfix, expression);
+        status = 2;
+    }
+
+    rpn_writer_flush(&rpn_writer);
+    token_list_free(postfix);
+    return rpn_writer.error ? 1 : status;
+}
+
+// === Streaming ===
+
+/// @brief One output line per input expression; lines that fail to convert are left empty so the
+///        output stays aligned with the input, and the failure is reported on stderr.
+static int rpn_drain(ShuntStream* stream) {
+    size_t failures = 0;
+    size_t written = 0; // lines written so far
+    ShuntStreamLine line;
+    while (shunt_stream_next(stream, &line)) {
+        for (; written + 1 < line.number; written++) {
+            rpn_writer_putc(&rpn_writer, '\n'); // blank input lines
+        }
+        written++;
+
+        if (line.error.code == SHUNT_STATUS_OK) {
+            rpn_write_postfix(&rpn_writer, line.postfix);
+        } else {
+            rpn_writer_putc(&rpn_writer, '\n');
+            fprintf(
+                stderr,
+                "[ERROR] line %zu, column %zu: %s: %.*s\n",
+                line.number,
+                line.error.column + 1,
+                shunt_status_to_string(line.error.code),
+                (int) line.length,
+                line.text
+            );
+            failures++;
+        }
+    }
+
+    rpn_writer_flush(&rpn_writer);
+    if (shunt_stream_failed(stream)) {
+        fprintf(stderr, "[ERROR] Failed to read input.\n");
+        return 1;
+    }
+    if (rpn_writer.error) {
+        fprintf(stderr, "[ERROR] Failed to write output.\n");
+        return 1;
+    }
+    return failures > 0 ? 2 : 0;
+}
+
+static int rpn_stream(const char* path) {
+    int fd = STDIN_FILENO;
+    if (path && strcmp(path, "-") != 0) {
+        fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            fprintf(stderr, "[ERROR] Failed to open '%s'.\n", path);
+            return 1;
+        }
+    }
+
+    int status = 1;
+    ShuntStream* stream = shunt_stream_open_fd(fd, 0);
+    if (stream) {
+        status = rpn_drain(stream);
+    } else {
+        fprintf(stderr, "[ERROR] Failed to create stream.\n");
+    }
+
+    shunt_stream_free(stream);
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+    return status;
+}
+
+/// @brief Maps the whole file read-only (*data is NULL for an empty file).
+/// @return false after reporting why the file cannot be mapped.
+static bool rpn_map(const char* path, const void** data, size_t* size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "[ERROR] Failed to open '%s'.\n", path);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        fprintf(stderr, "[ERROR] '%s' is not a regular file.\n", path);
+        close(fd);
+        return false;
+    }
+
+    *size = (size_t) info.st_size;
+    *data = NULL;
+    if (*size > 0) {
+        void* mapping = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            fprintf(stderr, "[ERROR] Failed to map '%s'.\n", path);
+            close(fd);
+            return false;
+        }
+        *data = mapping;
+    }
+    close(fd); // the mapping keeps the file alive
+    return true;
+}
+
+/// @brief Maps the whole file read-only and lexes straight out of the mapping, so input bytes are
+///        never copied: every lexeme is a view into the page cache.
+static int rpn_mmap(const char* path) {
+    const void* mapping = NULL;
+    size_t size = 0;
+    if (!rpn_map(path, &mapping, &size)) {
+        return 1;
+    }
+
+    const char* data = mapping;
+    if (data) {
+        madvise((void*) data, size, MADV_SEQUENTIAL);
+    }
+
+    int status = 1;
+    ShuntStream* stream = shunt_stream_open_memory(data, size);
+    if (stream) {
+        status = rpn_drain(stream);
+    } else {
+        fprintf(stderr, "[ERROR] Failed to create stream.\n");
+    }
+
+    shunt_stream_free(stream);
+    if (data) {
+        munmap((void*) data, size);
+    }
+    return status;
+}
+
+// === Bytecode Images ===
+
+/// @brief Appends one image per line that converts; failures are reported and skipped.
+static int rpn_compile(const char* path, const char* out) {
+    int input = strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDONLY);
+    if (input < 0) {
+        fprintf(stderr, "[ERROR] Failed to open '%s'.\n", path);
+        return 1;
+    }
+
+    int output = open(out, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ShuntStream* stream = output >= 0 ? shunt_stream_open_fd(input, 0) : NULL;
+    if (!stream) {
+        fprintf(stderr, "[ERROR] Failed to create '%s'.\n", out);
+        if (output >= 0) {
+            close(output);
+        }
+        if (input != STDIN_FILENO) {
+            close(input);
+        }
+        return 1;
+    }
+
+    rpn_writer.fd = output; // images go to the file, not stdout
+    size_t failures = 0;
+    uint8_t local[4096];
+    ShuntStreamLine line;
+    while (shunt_stream_next(stream, &line)) {
+        Bytecode* program = line.error.code == SHUNT_STATUS_OK ? bytecode_compile(line.postfix)
+                                                               : NULL;
+        const size_t size = bytecode_image_size(program);
+        uint8_t* image = size <= sizeof(local) ? local : malloc(size);
+        if (size > 0 && image && bytecode_serialize(program, image, size) == size) {
+            rpn_writer_put(&rpn_writer, (const char*) image, size);
+        } else {
+            // A converted line fails to compile on a literal that does not fit, or out of memory
+            ShuntStatus code = line.error.code;
+            if (!program && code == SHUNT_STATUS_OK) {
+                code = bytecode_range_fault(line.postfix) ? SHUNT_STATUS_RANGE
+                                                          : SHUNT_STATUS_MEMORY;
+            } else if (program) {
+                code = SHUNT_STATUS_MEMORY;
+            }
+            fprintf(
+                stderr,
+                "[ERROR] line %zu: %s: %.*s\n",
+                line.number,
+                shunt_status_to_string(code),
+                (int) line.length,
+                line.text
+            );
+            failures++;
+        }
+
+        if (image != local) {
+            free(image);
+        }
+        bytecode_free(program);
+    }
+
+    rpn_writer_flush(&rpn_writer);
+    const bool failed = shunt_stream_failed(stream) || rpn_writer.error;
+    rpn_writer = (RpnWriter) {.fd = STDOUT_FILENO};
+    shunt_stream_free(stream);
+    close(output);
+    if (input != STDIN_FILENO) {
+        close(input);
+    }
+
+    if (failed) {
+        fprintf(stderr, "[ERROR] Failed to compile '%s' into '%s'.\n", path, out);
+        return 1;
+    }
+    return failures > 0 ? 2 : 0;
+}
+
+/// @brief Loads each program straight from the mapping (no parsing, no copies) and prints its
+///        value. Programs with variables have nothing to bind here and print an empty line.
+static int rpn_run(const char* path) {
+    const void* data = NULL;
+    size_t size = 0;
+    if (!rpn_map(path, &data, &size)) {
+        return 1;
+    }
+
+    int status = 0;
+    size_t offset = 0;
+    while (offset < size) {
+        size_t consumed = 0;
+        Bytecode* program = bytecode_load((const uint8_t*) data + offset, size - offset, &consumed);
+        if (!program) {
+            fprintf(stderr, "[ERROR] Bad image at byte %zu of '%s'.\n", offset, path);
+            status = 1;
+            break;
+        }
+        offset += consumed;
+
+        RpnValue result;
+        char value[64];
+        int length = 0;
+        if (program->variable_count == 0 && bytecode_execute(program, NULL, &result)) {
+            length = result.type == TOKEN_TYPE_INTEGER
+                         ? snprintf(value, sizeof(value), "%lld", (long long) result.integer)
+                         : snprintf(value, sizeof(value), "%.17g", result.real);
+        } else {
+            status = 2;
+        }
+        rpn_writer_put(&rpn_writer, value, (size_t) length);
+        rpn_writer_putc(&rpn_writer, '\n');
+        bytecode_free(program);
+    }
+
+    rpn_writer_flush(&rpn_writer);
+    if (data) {
+        munmap((void*) data, size);
+    }
+    return rpn_writer.error ? 1 : status;
+}
+
+// === Main ===
+
+static void rpn_usage(FILE* out, const char* program) {
+    fprintf(
+        out,
+        "Usage: %s [\"<expression>\" | --stream [file|-] | --mmap file | --compile file out |"
+        " --run file | --help]\n"
+        "  (no arguments)      run the built-in sample expression\n"
+        "  <expression>        print the postfix form and its value (none if it has variables)\n"
+        "  --stream [file]     convert one expression per line from file or stdin\n"
+        "  --mmap file         like --stream, lexing directly from a memory-mapped file\n"
+        "  --compile file out  compile one expression per line (file or -) into an image file\n"
+        "  --run file          evaluate every program of an image file straight from a mapping\n",
+        program
+    );
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        return rpn_sample();
+    }
+
+    const char* command = argv[1];
+    if (strcmp(command, "-h") == 0 || strcmp(command, "--help") == 0) {
+        rpn_usage(stdout, argv[0]);
+        return 0;
+    }
+
+    if (strcmp(command, "--stream") == 0 && argc <= 3) {
+        return rpn_stream(argc > 2 ? argv[2] : NULL);
+    }
+
+    if (strcmp(command, "--mmap") == 0 && argc == 3) {
+        return rpn_mmap(argv[2]);
+    }
+
+    if (strcmp(command, "--compile") == 0 && argc == 4) {
+        return rpn_compile(argv[2], argv[3]);
+    }
+
+    if (strcmp(command, "--run") == 0 && argc == 3) {
+        return rpn_run(argv[2]);
+    }
+
+    if (strncmp(command, "--", 2) != 0 && argc == 2) {
+        return rpn_expression(command);
+    }
+
+    rpn_usage(stderr, argv[0]);
+    return 1;
+}
+
 // === End ===
@@ -0,0 +1,488 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file src/parallel.c
+ * @brief Spreads the conversion of one very large expression across a worker pool.
+ * @note Workers claim tasks (byte chunks, then groups) from a shared atomic cursor, the same way
+ *       batch workers claim expressions. Seams and stitching are sequential, linear memcpy passes.
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "lexer/tokenizer.h"
+#include "parser.h"
+#include "parallel.h"
+
+#define SHUNT_PARALLEL_SPLIT 4 // Tasks per worker, so uneven tasks balance out
+
+// --- Worker Pool ---
+
+typedef void (*ShuntParallelTask)(void* tasks, size_t index);
+
+typedef struct ShuntParallelJob {
+    ShuntParallelTask run;
+    void* tasks;
+    size_t count;
+    atomic_size_t next; // First unclaimed task
+} ShuntParallelJob;
+
+static void* shunt_parallel_work(void* arg) {
+    ShuntParallelJob* job = arg;
+    while (true) {
+        const size_t index = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed);
+        if (index >= job->count) {
+            break;
+        }
+        job->run(job->tasks, index);
+    }
+    return NULL;
+}
+
+static size_t shunt_parallel_thread_count(size_t threads) {
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (size_t) online : 1;
+    }
+    return threads;
+}
+
+/// @brief Runs every task, on the calling thread plus up to threads - 1 helpers.
+/// @note A helper that fails to start leaves its share to the rest.
+static void shunt_parallel_for(size_t threads, ShuntParallelTask run, void* tasks, size_t count) {
+    ShuntParallelJob job = {.run = run, .tasks = tasks, .count = count};
+    atomic_init(&job.next, 0);
+
+    if (threads > count) {
+        threads = count;
+    }
+    pthread_t* handles = threads > 1 ? calloc(threads - 1, sizeof(pthread_t)) : NULL;
+    size_t started = 0;
+    for (size_t i = 1; handles && i < threads; i++) {
+        if (pthread_create(&handles[started], NULL, shunt_parallel_work, &job) == 0) {
+            started++;
+        }
+    }
+
+    shunt_parallel_work(&job);
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(handles[i], NULL);
+    }
+    free(handles);
+}
+
+// --- Token Ranges ---
+
+/// @brief Appends tokens [from, to) of source to array.
+static bool shunt_parallel_append(
+    TokenArray* array, const TokenArray* source, size_t from, size_t to
+) {
+    const size_t count = to - from;
+    if (!token_array_reserve(array, array->count + count)) {
+        return false;
+    }
+
+    memcpy(array->tags + array->count, source->tags + from, sizeof(TokenTag) * count);
+    memcpy(array->offsets + array->count, source->offsets + from, sizeof(uint32_t) * count);
+    memcpy(array->sizes + array->count, source->sizes + from, sizeof(uint32_t) * count);
+    array->count += count;
+    return true;
+}
+
+// --- Chunked Tokenizing ---
+
+typedef struct ShuntParallelChunk {
+    const char* source;
+    size_t length; // Whole source, so the last token of a chunk may run past its end
+    size_t start;
+    size_t end;
+    TokenArray* tokens; // Every token the chunk lexer starts in [start, end)
+    ShuntError error; // Where the chunk lexer stopped early (may be spurious, see the seams)
+} ShuntParallelChunk;
+
+static void shunt_parallel_lex(void* tasks, size_t index) {
+    ShuntParallelChunk* chunk = (ShuntParallelChunk*) tasks + index;
+
+    chunk->tokens = token_array_create(chunk->source);
+    const size_t capacity = tokenizer_capacity_hint(chunk->end - chunk->start);
+    if (!chunk->tokens || !token_array_reserve(chunk->tokens, capacity)) {
+        shunt_error_set(&chunk->error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, chunk->start, 0);
+        return;
+    }
+
+    Lexer lexer;
+    lexer_init(&lexer, chunk->source, chunk->length, NULL, true);
+    lexer.offset = chunk->start;
+    while (lexer.offset < chunk->end) {
+        TokenType type;
+        size_t offset;
+        size_t size;
+        if (!lexer_scan(&lexer, &type, &offset, &size)) {
+            chunk->error = lexer.error;
+            return;
+        }
+
+        if (size == 0 || offset >= chunk->end) {
+            break; // end of input, or the next chunk's token
+        }
+
+        const TokenTag tag = token_tag_lexed(type);
+        if (!token_array_push(chunk->tokens, tag, (uint32_t) offset, (uint32_t) size)) {
+            shunt_error_set(&chunk->error, SHUNT_STATUS_MEMORY, type, offset, size);
+            return;
+        }
+    }
+}
+
+/// @brief Appends the chunk's tokens to array, re-lexing from offset until a token of the whole
+///        text starts where a chunk token starts, since the rest of the chunk then agrees.
+/// @param offset End of the last token of the whole text lexed so far; advanced past the chunk.
+static bool shunt_parallel_seam(
+    TokenArray* array, const ShuntParallelChunk* chunk, size_t* offset, ShuntError* error
+) {
+    if (chunk->error.code == SHUNT_STATUS_MEMORY) {
+        shunt_error_set(error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, chunk->start, 0);
+        return false;
+    }
+
+    const TokenArray* tokens = chunk->tokens;
+    Lexer lexer;
+    lexer_init(&lexer, chunk->source, chunk->length, NULL, true);
+    lexer.offset = *offset;
+
+    size_t index = 0;
+    while (true) {
+        TokenType type;
+        size_t start;
+        size_t size;
+        if (!lexer_scan(&lexer, &type, &start, &size)) {
+            if (error) {
+                *error = lexer.error;
+            }
+            return false;
+        }
+
+        if (size == 0 || start >= chunk->end) {
+            *offset = start; // no token starts in the rest of the chunk
+            return true;
+        }
+
+        while (index < tokens->count && tokens->offsets[index] < start) {
+            index++;
+        }
+        if (index < tokens->count && tokens->offsets[index] == start) {
+            break; // in step: the chunk's tokens from here on are the whole text's
+        }
+
+        const TokenTag tag = token_tag_lexed(type);
+        if (!token_array_push(array, tag, (uint32_t) start, (uint32_t) size)) {
+            shunt_error_set(error, SHUNT_STATUS_MEMORY, type, start, size);
+            return false;
+        }
+        *offset = start + size;
+    }
+
+    if (!shunt_parallel_append(array, tokens, index, tokens->count)) {
+        shunt_error_set(error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, chunk->start, 0);
+        return false;
+    }
+
+    if (chunk->error.code != SHUNT_STATUS_OK) {
+        // Lexing in step reaches the same character, so the failure is real
+        if (error) {
+            *error = chunk->error;
+        }
+        return false;
+    }
+
+    const size_t last = tokens->count - 1;
+    *offset = (size_t) tokens->offsets[last] + tokens->sizes[last];
+    return true;
+}
+
+TokenArray* shunt_parallel_tokenize(
+    const char* expression, size_t length, size_t threads, ShuntError* error
+) {
+    shunt_error_set(error, SHUNT_STATUS_OK, TOKEN_TYPE_NONE, 0, 0);
+    if (!expression || length > UINT32_MAX) {
+        shunt_error_set(error, SHUNT_STATUS_EMPTY, TOKEN_TYPE_NONE, 0, 0);
+        return NULL;
+    }
+
+    threads = shunt_parallel_thread_count(threads);
+    size_t count = threads * SHUNT_PARALLEL_SPLIT;
+    if (count > length / SHUNT_PARALLEL_CHUNK) {
+        count = length / SHUNT_PARALLEL_CHUNK;
+    }
+    if (count < 2) {
+        count = 1; // a single chunk starts at 0 and needs no seam
+    }
+
+    TokenArray* array = token_array_create(expression);
+    ShuntParallelChunk* chunks = calloc(count, sizeof(ShuntParallelChunk));
+    if (!array || !chunks || !token_array_reserve(array, tokenizer_capacity_hint(length))) {
+        shunt_error_set(error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, 0, 0);
+        token_array_free(array);
+        free(chunks);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        chunks[i] = (ShuntParallelChunk) {
+            .source = expression,
+            .length = length,
+            .start = length / count * i,
+            .end = i + 1 < count ? length / count * (i + 1) : length,
+        };
+    }
+    shunt_parallel_for(threads, shunt_parallel_lex, chunks, count);
+
+    size_t offset = 0;
+    bool ok = true;
+    for (size_t i = 0; ok && i < count; i++) {
+        ok = shunt_parallel_seam(array, &chunks[i], &offset, error);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        token_array_free(chunks[i].tokens);
+    }
+    free(chunks);
+
+    if (!ok) {
+        token_array_free(array);
+        return NULL;
+    }
+    return array;
+}
+
+// --- Group Conversion ---
+
+typedef struct ShuntParallelGroup {
+    size_t open; // Infix index of the '('
+    size_t close; // Infix index of the matching ')'
+    const TokenArray* infix;
+    TokenArray* postfix; // Postfix of the interior (NULL if it failed)
+    ShuntError error; // Why the interior failed
+} ShuntParallelGroup;
+
+static void shunt_parallel_shunt(void* tasks, size_t index) {
+    ShuntParallelGroup* group = (ShuntParallelGroup*) tasks + index;
+    const TokenArray* infix = group->infix;
+
+    // Borrow the group's interior as its own infix
+    const size_t count = group->close - group->open - 1;
+    TokenArray interior = {
+        .count = count,
+        .capacity = count,
+        .source = infix->source,
+        .tags = infix->tags + group->open + 1,
+        .offsets = infix->offsets + group->open + 1,
+        .sizes = infix->sizes + group->open + 1,
+    };
+    group->postfix = shunt_yard_array_checked(&interior, &group->error);
+}
+
+/// @brief Picks the outermost groups whose interior holds between SHUNT_PARALLEL_GRAIN and
+///        `limit` tokens, in infix order. Larger groups are split into their own subgroups.
+/// @return The group count, or SIZE_MAX if memory runs out.
+static size_t shunt_parallel_groups(
+    const TokenArray* infix, size_t limit, ShuntParallelGroup** groups
+) {
+    size_t* opens = malloc(sizeof(size_t) * infix->count); // Stack of unmatched '(' indices
+    size_t capacity = 16;
+    size_t count = 0;
+    *groups = malloc(sizeof(ShuntParallelGroup) * capacity);
+    if (!opens || !*groups) {
+        free(opens);
+        free(*groups);
+        return SIZE_MAX;
+    }
+
+    size_t top = 0;
+    for (size_t i = 0; i < infix->count; i++) {
+        const TokenType type = token_tag_type(infix->tags[i]);
+        if (type == TOKEN_TYPE_LEFT_PAREN) {
+            opens[top++] = i;
+            continue;
+        }
+        if (type != TOKEN_TYPE_RIGHT_PAREN || top == 0) {
+            continue; // a stray ')' is left for the sequential pass to reject
+        }
+
+        // Groups close innermost first, so a chosen group replaces the subgroups chosen inside it
+        const size_t open = opens[--top];
+        const size_t size = i - open - 1;
+        if (size > limit) {
+            continue;
+        }
+        while (count > 0 && (*groups)[count - 1].open > open) {
+            count--;
+        }
+        if (size < SHUNT_PARALLEL_GRAIN) {
+            continue;
+        }
+
+        if (count == capacity) {
+            ShuntParallelGroup* grown = realloc(*groups, sizeof(ShuntParallelGroup) * capacity * 2);
+            if (!grown) {
+                free(opens);
+                free(*groups);
+                return SIZE_MAX;
+            }
+            *groups = grown;
+            capacity *= 2;
+        }
+        (*groups)[count++] = (ShuntParallelGroup) {.open = open, .close = i, .infix = infix};
+    }
+
+    free(opens);
+    return count;
+}
+
+/// @brief The infix with every group collapsed into a placeholder: a zero-size identifier at the
+///        group's '(' offset, which no lexed token can be.
+static TokenArray* shunt_parallel_skeleton(
+    const TokenArray* infix, const ShuntParallelGroup* groups, size_t count
+) {
+    TokenArray* skeleton = token_array_create(infix->source);
+    if (!skeleton) {
+        return NULL;
+    }
+
+    const TokenTag placeholder = token_tag_lexed(TOKEN_TYPE_IDENTIFIER);
+    size_t from = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!shunt_parallel_append(skeleton, infix, from, groups[i].open)
+            || !token_array_push(skeleton, placeholder, infix->offsets[groups[i].open], 0)) {
+            token_array_free(skeleton);
+            return NULL;
+        }
+        from = groups[i].close + 1;
+    }
+
+    if (!shunt_parallel_append(skeleton, infix, from, infix->count)) {
+        token_array_free(skeleton);
+        return NULL;
+    }
+    return skeleton;
+}
+
+/// @brief Replaces each placeholder in the skeleton's postfix with its group's postfix. Operands
+///        keep their infix order through the shunting-yard, so the placeholders come in order.
+static TokenArray* shunt_parallel_stitch(
+    const TokenArray* outline, const ShuntParallelGroup* groups, size_t count
+) {
+    size_t total = outline->count - count;
+    for (size_t i = 0; i < count; i++) {
+        total += groups[i].postfix->count;
+    }
+
+    TokenArray* postfix = token_array_create(outline->source);
+    if (!postfix || !token_array_reserve(postfix, total)) {
+        token_array_free(postfix);
+        return NULL;
+    }
+
+    size_t from = 0;
+    size_t group = 0;
+    for (size_t i = 0; i < outline->count; i++) {
+        if (outline->sizes[i] != 0) {
+            continue;
+        }
+
+        const TokenArray* interior = groups[group++].postfix;
+        shunt_parallel_append(postfix, outline, from, i);
+        shunt_parallel_append(postfix, interior, 0, interior->count);
+        from = i + 1;
+    }
+    shunt_parallel_append(postfix, outline, from, outline->count);
+    return postfix;
+}
+
+/// @brief shunt_parallel_yard() reporting failures like shunt_yard_array_checked().
+static TokenArray* shunt_parallel_convert(
+    const TokenArray* infix, size_t threads, ShuntError* error
+) {
+    shunt_error_set(error, SHUNT_STATUS_OK, TOKEN_TYPE_NONE, 0, 0);
+    if (!infix || token_array_is_empty(infix)) {
+        shunt_error_set(error, SHUNT_STATUS_EMPTY, TOKEN_TYPE_NONE, 0, 0);
+        return NULL;
+    }
+
+    threads = shunt_parallel_thread_count(threads);
+    if (threads < 2 || infix->count < SHUNT_PARALLEL_GRAIN * 2) {
+        return shunt_yard_array_checked(infix, error);
+    }
+
+    ShuntParallelGroup* groups = NULL;
+    size_t limit = infix->count / (threads * SHUNT_PARALLEL_SPLIT);
+    if (limit < SHUNT_PARALLEL_GRAIN) {
+        limit = SHUNT_PARALLEL_GRAIN;
+    }
+    const size_t count = shunt_parallel_groups(infix, limit, &groups);
+    if (count == SIZE_MAX) {
+        shunt_error_set(error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, 0, 0);
+        return NULL;
+    }
+    if (count == 0) {
+        free(groups);
+        return shunt_yard_array_checked(infix, error); // nothing large enough to split off
+    }
+
+    shunt_parallel_for(threads, shunt_parallel_shunt, groups, count);
+
+    // Interiors are balanced by construction, so one can only have run out of memory
+    TokenArray* postfix = NULL;
+    bool converted = true;
+    for (size_t i = 0; converted && i < count; i++) {
+        if (!groups[i].postfix) {
+            converted = false;
+            if (error) {
+                *error = groups[i].error;
+            }
+        }
+    }
+
+    if (converted) {
+        TokenArray* skeleton = shunt_parallel_skeleton(infix, groups, count);
+        TokenArray* outline = skeleton ? shunt_yard_array_checked(skeleton, error) : NULL;
+        postfix = outline ? shunt_parallel_stitch(outline, groups, count) : NULL;
+        if (!skeleton || (outline && !postfix)) {
+            shunt_error_set(error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, 0, 0);
+        }
+        token_array_free(outline);
+        token_array_free(skeleton);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        token_array_free(groups[i].postfix);
+    }
+    free(groups);
+    return postfix;
+}
+
+TokenArray* shunt_parallel_yard(const TokenArray* infix, size_t threads) {
+    return shunt_parallel_convert(infix, threads, NULL);
+}
+
+TokenArray* shunt_parallel_expression(
+    const char* expression, size_t length, size_t threads, ShuntError* error
+) {
+    TokenArray* infix = shunt_parallel_tokenize(expression, length, threads, error);
+    if (!infix) {
+        return NULL;
+    }
+
+    if (token_array_is_empty(infix)) {
+        shunt_error_set(error, SHUNT_STATUS_EMPTY, TOKEN_TYPE_NONE, 0, 0);
+        token_array_free(infix);
+        return NULL;
+    }
+
+    TokenArray* postfix = shunt_parallel_convert(infix, threads, error);
+    token_array_free(infix);
+    return postfix;
+}
@@ -10,140 +10,857 @@
 #include "lexer/token_list.h"
 #include "lexer/tokenizer.h"
 #include "parser.h"
+#include "stats.h"
+#include "tree.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <stdio.h>
 
-static void shunt_unary(const TokenList* infix, const Token* symbol, size_t i) {
-    if (!infix || !infix->tokens || !symbol) {
+// --- Shunting State Machine ---
+
+/// @brief Parser state carried between tokens. Only the previous token type is needed to resolve
+///        unary operators, so tokens can be fed one at a time straight from the lexer.
+typedef struct ShuntState {
+    TokenList* postfix; // Output queue
+    TokenList* operators; // Operator stack
+    TokenType previous; // Type of the last token seen (NONE at the start)
+    ShuntError error; // Why the last step failed
+    bool validate; // Reject malformed infix while converting
+    bool adopt; // Symbols belong to the state (heap tokens from the lexer): move, don't clone
+    size_t depth; // Evaluation stack depth of the output emitted so far
+    size_t peak; // Highest depth reached
+    ShuntTree* tree; // Built from the output as it is emitted (NULL if not requested)
+    ShuntLimits limits; // Bounds on the input (all zero: unbounded)
+} ShuntState;
+
+/// @brief True if the previous token ends an operand, i.e. the next operator is binary.
+static bool shunt_type_ends_operand(TokenType previous) {
+    switch (previous) {
+        case TOKEN_TYPE_INTEGER:
+        case TOKEN_TYPE_FLOAT:
+        case TOKEN_TYPE_IDENTIFIER:
+        case TOKEN_TYPE_RIGHT_PAREN:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// @brief True if the type has a prefix form (a unary descriptor that takes one operand).
+static bool shunt_type_has_unary(TokenType type) {
+    return token_descriptor(type, TOKEN_ROLE_UNARY)->arity == 1;
+}
+
+/// @brief Resolves the operator's role: unary where an operand is expected, binary otherwise.
+static void shunt_unary(TokenType previous, Token* symbol) {
+    if (!symbol) {
         return;
     }
 
-    const Token* prev = (i > 0) ? token_list_peek_index(infix, i - 1) : NULL;
+    const bool prefix = !shunt_type_ends_operand(previous) && shunt_type_has_unary(symbol->type);
+    symbol->role = prefix ? TOKEN_ROLE_UNARY : TOKEN_ROLE_BINARY;
+}
+
+/// @note Operators move between the stack and the output without cloning, so a popped token is
+///       only released when it is discarded (or could not be moved). Arena lists never free.
+static void shunt_release(const TokenList* list, Token* token) {
+    if (!list->arena) {
+        token_free(token);
+    }
+}
+
+/// @brief Tracks the stack depth evaluation would reach as tokens join the output queue.
+static void shunt_track(ShuntState* state, const Token* token) {
+    if (token_is_operand(token)) {
+        if (++state->depth > state->peak) {
+            state->peak = state->depth;
+        }
+    } else if (token_is_role_binary(token) && state->depth > 0) {
+        state->depth--; // two pops, one push
+    }
+}
+
+/// @brief Makes room for the next tree node before the token joins the output, so recording it
+///        afterwards cannot fail and leave the token in both the output and the caller's hands.
+static bool shunt_tree_ready(ShuntState* state) {
+    return !state->tree || shunt_tree_reserve(state->tree, state->tree->count + 1);
+}
+
+/// @brief Links the token that just joined the output into the tree.
+/// @note Cannot fail: room is reserved, and tree parses validate, so operands are never missing.
+static void shunt_tree_record(ShuntState* state) {
+    if (state->tree) {
+        shunt_tree_append(state->tree, token_list_peek(state->postfix));
+    }
+}
+
+/// @brief Appends a borrowed token to the output queue (heap lists clone it).
+static bool shunt_emit(ShuntState* state, const Token* token) {
+    if (!shunt_tree_ready(state)) {
+        return false;
+    }
+
+    shunt_track(state, token);
+    if (!token_list_push(state->postfix, token)) {
+        return false;
+    }
+    shunt_tree_record(state);
+    return true;
+}
+
+/// @brief Appends an owned token to the output queue, transferring the pointer.
+/// @note On failure the caller still owns the token.
+static bool shunt_emit_move(ShuntState* state, Token* token) {
+    if (!shunt_tree_ready(state)) {
+        return false;
+    }
+
+    shunt_track(state, token);
+    if (!token_list_push_move(state->postfix, token)) {
+        return false;
+    }
+    shunt_tree_record(state);
+    return true;
+}
+
+/// @brief Moves one operator from the top of the stack to the output queue.
+static bool shunt_transfer(ShuntState* state) {
+    Token* popped = token_list_pop_move(state->operators);
+    if (!shunt_emit_move(state, popped)) {
+        shunt_release(state->operators, popped);
+        return false;
+    }
+    return true;
+}
 
-    if (i == 0 || token_is_operator(prev) || token_is_type_left_paren(prev)) {
-        Token* editable = (Token*) symbol;
-        editable->role = TOKEN_ROLE_UNARY;
-        editable->association = TOKEN_ASSOCIATE_RIGHT;
-        editable->precedence = TOKEN_PRECEDENT_UNARY;
+/// @brief Fails with SHUNT_STATUS_LIMIT if pushing the symbol would exceed the stack bound.
+static bool shunt_room(ShuntState* state, const Token* symbol, size_t column) {
+    const size_t bound = state->limits.max_depth;
+    if (bound > 0 && state->operators->count >= bound) {
+        shunt_error_set(&state->error, SHUNT_STATUS_LIMIT, symbol->type, column, symbol->size);
+        return false;
     }
+    return true;
 }
 
-static bool shunt_precedent(TokenList* postfix, TokenList* operators, const Token* symbol) {
+static bool shunt_precedent(ShuntState* state, const Token* symbol) {
+    TokenList* operators = state->operators;
+
+    // A prefix operator has no left operand, so nothing on the stack can be complete yet
+    const TokenDescriptor* incoming = token_descriptor(symbol->type, symbol->role);
+    if (incoming->arity == 1) {
+        return true;
+    }
+
+    size_t pops = 0;
     while (true) {
         const Token* op = token_list_peek(operators);
         if (!token_is_operator(op) || token_is_type_left_paren(op)) {
             break;
         }
 
-        int o1 = token_precedence(symbol);
-        int o2 = token_precedence(op);
-        if (o2 > o1 || (o2 == o1 && token_is_associate_left(symbol))) {
-            Token* popped = token_list_pop(operators);
-            if (!token_list_push(postfix, popped)) {
-                token_free(popped);
+        // Use the resolved precedence so unary operators bind tighter than binary ones
+        int o1 = incoming->precedence;
+        int o2 = token_descriptor(op->type, op->role)->precedence;
+        if (o2 > o1 || (o2 == o1 && incoming->association == TOKEN_ASSOCIATE_LEFT)) {
+            if (!shunt_transfer(state)) {
                 return false;
             }
-            token_free(popped);
+            pops++;
         } else {
             break;
         }
     }
 
+    SHUNT_STAT_INC(SHUNT_STAT_PRECEDENT_CALLS);
+    SHUNT_STAT_ADD(SHUNT_STAT_PRECEDENT_POPS, pops);
     return true;
 }
 
-static bool shunt_group(TokenList* postfix, TokenList* operators, size_t i) {
+/// @brief Pops operators to the output up to the matching '(' and discards it.
+static bool shunt_group(ShuntState* state, const Token* symbol, size_t column) {
+    TokenList* operators = state->operators;
+
+    size_t pops = 0;
     while (true) {
         const Token* op = token_list_peek(operators);
         if (!op || token_is_type_left_paren(op) || token_list_is_empty(operators)) {
             break;
         }
 
-        Token* popped = token_list_pop(operators);
-        if (!token_list_push(postfix, popped)) {
-            token_free(popped);
+        if (!shunt_transfer(state)) {
+            shunt_error_set(&state->error, SHUNT_STATUS_MEMORY, symbol->type, column, symbol->size);
             return false;
         }
-        token_free(popped);
+        pops++;
     }
-    
+
+    SHUNT_STAT_INC(SHUNT_STAT_GROUP_CALLS);
+    SHUNT_STAT_ADD(SHUNT_STAT_GROUP_POPS, pops);
+
     const Token* op = token_list_peek(operators);
-    if (op && token_is_type_left_paren(op)) {
-        Token* temp = token_list_pop(operators);
-        token_free(temp);
-    } else {
-        fprintf(stderr, "[ERROR] Mismatched parentheses in column %zu\n", i);
+    if (!op || !token_is_type_left_paren(op)) {
+        shunt_error_set(&state->error, SHUNT_STATUS_UNBALANCED, symbol->type, column, symbol->size);
         return false;
     }
 
+    shunt_release(operators, token_list_pop_move(operators));
     return true;
 }
 
-TokenList* shunt_yard(const TokenList* infix) {
-    if (!infix || !infix->tokens || token_list_is_empty(infix)) {
+static TokenList* shunt_list_create(Arena* arena, size_t capacity) {
+    TokenList* list = arena ? token_list_create_arena(arena)
+                            : token_list_create_with_capacity(capacity);
+    if (list && !token_list_reserve(list, capacity)) {
+        token_list_free(list);
         return NULL;
     }
+    return list;
+}
 
-    TokenList* postfix = token_list_create();
-    TokenList* operators = token_list_create();
+/// @note A NULL arena clones every emitted token onto the heap. With an arena, both lists borrow
+///       the tokens, so no token is copied or freed.
+/// @param capacity Upper bound (or estimate) of the infix token count. Postfix output is never
+///        longer than the infix, and the operator stack never holds more than it.
+/// @param limits Bounds on the input (may be NULL). Neither list is reserved beyond them.
+static bool shunt_begin(
+    ShuntState* state, Arena* arena, size_t capacity, const ShuntLimits* limits
+) {
+    state->limits = limits ? *limits : (ShuntLimits) {0};
+    if (state->limits.max_tokens > 0 && state->limits.max_tokens < capacity) {
+        capacity = state->limits.max_tokens;
+    }
+    size_t stack = capacity;
+    if (state->limits.max_depth > 0 && state->limits.max_depth < stack) {
+        stack = state->limits.max_depth;
+    }
 
-    for (size_t i = 0; i < infix->count; i++) {
-        const Token* symbol = token_list_peek_index(infix, i);
-        if (!symbol) {
-            break; // Out-of-bounds
+    state->postfix = shunt_list_create(arena, capacity);
+    state->operators = shunt_list_create(arena, stack);
+    state->previous = TOKEN_TYPE_NONE;
+    state->error = (ShuntError) {.code = SHUNT_STATUS_OK};
+    state->validate = false;
+    state->adopt = false;
+    state->depth = 0;
+    state->peak = 0;
+    state->tree = NULL;
+    if (!state->postfix || !state->operators) {
+        shunt_error_set(&state->error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, 0, 0);
+        return false;
+    }
+    return true;
+}
+
+/// @brief Attaches the tree to a fresh state, cleared and sized like the output queue.
+static bool shunt_plant(ShuntState* state, ShuntTree* tree, size_t capacity) {
+    if (!tree) {
+        return true;
+    }
+
+    shunt_tree_clear(tree);
+    if (!shunt_tree_reserve(tree, capacity)) {
+        shunt_error_set(&state->error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, 0, 0);
+        return false;
+    }
+    state->tree = tree;
+    return true;
+}
+
+/// @brief Infix adjacency rules that, together with balanced groups, guarantee the output reduces
+///        to a single value: operands and '(' only where an operand may start, ')' only after one
+///        ends, and only operators with a prefix form ('+' / '-') in unary position.
+static bool shunt_check(const ShuntState* state, const Token* symbol) {
+    const bool after_operand = shunt_type_ends_operand(state->previous);
+
+    if (token_is_operand(symbol) || token_is_type_left_paren(symbol)) {
+        return !after_operand;
+    }
+    if (token_is_type_right_paren(symbol)) {
+        return after_operand;
+    }
+    if (token_is_operator(symbol) && !after_operand) {
+        return shunt_type_has_unary(symbol->type);
+    }
+    return true;
+}
+
+/// @brief Stores the symbol in a list: moved when the state owns it, cloned (heap) otherwise.
+static bool shunt_store(ShuntState* state, TokenList* list, Token* symbol) {
+    if (list == state->postfix) {
+        return state->adopt ? shunt_emit_move(state, symbol) : shunt_emit(state, symbol);
+    }
+    return state->adopt ? token_list_push_move(list, symbol) : token_list_push(list, symbol);
+}
+
+/// @brief Applies one infix token to the output queue and operator stack.
+static bool shunt_apply(ShuntState* state, Token* symbol, size_t column, bool* stored) {
+    if (state->validate && !shunt_check(state, symbol)) {
+        shunt_error_set(&state->error, SHUNT_STATUS_MALFORMED, symbol->type, column, symbol->size);
+        return false;
+    }
+
+    bool ok = true;
+    if (token_is_operand(symbol)) {
+        ok = shunt_store(state, state->postfix, symbol);
+        *stored = ok;
+    } else if (token_is_operator(symbol)) {
+        shunt_unary(state->previous, symbol);
+        if (!shunt_precedent(state, symbol)) {
+            ok = false;
+        } else if (!shunt_room(state, symbol, column)) {
+            return false; // reported by shunt_room
+        } else {
+            ok = shunt_store(state, state->operators, symbol);
+        }
+        *stored = ok;
+    } else if (token_is_type_left_paren(symbol)) {
+        if (!shunt_room(state, symbol, column)) {
+            return false; // reported by shunt_room
+        }
+        ok = shunt_store(state, state->operators, symbol);
+        *stored = ok;
+    } else if (token_is_type_right_paren(symbol)) {
+        if (!shunt_group(state, symbol, column)) {
+            return false; // reported by shunt_group
         }
+    }
 
-        if (token_is_number(symbol)) {
-            if (!token_list_push(postfix, (Token*) symbol)) {
-                fprintf(stderr, "[ERROR] Failed to push token to output queue.\n");
-                goto error;
+    if (!ok) {
+        shunt_error_set(&state->error, SHUNT_STATUS_MEMORY, symbol->type, column, symbol->size);
+        return false;
+    }
+
+    state->previous = symbol->type;
+    return true;
+}
+
+/// @brief Feeds one infix token through the algorithm. The token may be re-tagged as unary.
+/// @param column Where the token starts, reported if it causes the failure.
+/// @note An adopted symbol is always consumed: moved into a list, or freed if it is not kept
+///       (a ')') or the step fails.
+static bool shunt_step(ShuntState* state, Token* symbol, size_t column) {
+    bool stored = false;
+    bool ok = shunt_apply(state, symbol, column, &stored);
+    if (state->adopt && !stored) {
+        token_free(symbol);
+    }
+    return ok;
+}
+
+/// @brief Drains the operator stack into the output queue.
+/// @param column End of input, reported for a '(' that was never closed.
+static bool shunt_drain(ShuntState* state, size_t column) {
+    TokenList* operators = state->operators;
+
+    // An expression may not end where an operand is still expected
+    if (state->validate && !shunt_type_ends_operand(state->previous)) {
+        shunt_error_set(&state->error, SHUNT_STATUS_MALFORMED, TOKEN_TYPE_NONE, column, 0);
+        return false;
+    }
+
+    while (!token_list_is_empty(operators)) {
+        const TokenType type = token_list_peek(operators)->type;
+        bool ok = type != TOKEN_TYPE_LEFT_PAREN && shunt_transfer(state);
+        if (!ok) {
+            ShuntStatus code
+                = type == TOKEN_TYPE_LEFT_PAREN ? SHUNT_STATUS_UNBALANCED : SHUNT_STATUS_MEMORY;
+            shunt_error_set(&state->error, code, type, column, 0);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// @brief Drains the operator stack and hands the output queue to the caller.
+static TokenList* shunt_end(ShuntState* state, size_t column) {
+    if (!shunt_drain(state, column)) {
+        return NULL;
+    }
+
+    TokenList* postfix = state->postfix;
+    token_list_free(state->operators);
+    state->operators = NULL;
+    state->postfix = NULL;
+    return postfix;
+}
+
+/// @brief Lexes the whole source through the state machine.
+static bool shunt_lex(ShuntState* state, Lexer* lexer) {
+    size_t lexed = 0;
+    while (true) {
+        Token* token = NULL;
+        if (!lexer_next(lexer, &token)) {
+            state->error = lexer->error;
+            return false;
+        }
+
+        if (!token) {
+            break; // end of input
+        }
+
+        if (state->limits.max_tokens > 0 && lexed == state->limits.max_tokens) {
+            const size_t column = lexer->offset - token->size;
+            shunt_error_set(&state->error, SHUNT_STATUS_LIMIT, token->type, column, token->size);
+            if (state->adopt) {
+                token_free(token);
             }
-        } else if (token_is_operator(symbol)) {
-            shunt_unary(infix, symbol, i);
+            return false;
+        }
 
-            if (!shunt_precedent(postfix, operators, symbol)) {
-                fprintf(stderr, "[ERROR] Failed during precedence resolution.\n");
-                goto error;
+        // Heap tokens are adopted by the step, arena tokens are borrowed
+        if (!shunt_step(state, token, lexer->offset - token->size)) {
+            return false;
+        }
+        lexed++;
+    }
+
+    SHUNT_STAT_ADD(SHUNT_STAT_TOKENS_LEXED, lexed);
+
+    if (state->previous == TOKEN_TYPE_NONE) {
+        shunt_error_set(&state->error, SHUNT_STATUS_EMPTY, TOKEN_TYPE_NONE, lexer->offset, 0);
+        return false; // reject empty expressions
+    }
+    return true;
+}
+
+static void shunt_abort(ShuntState* state) {
+    token_list_free(state->postfix);
+    token_list_free(state->operators);
+    state->postfix = NULL;
+    state->operators = NULL;
+}
+
+/// @brief Hands the outcome of a finished (or failed) conversion to the caller.
+static TokenList* shunt_finish(
+    ShuntState* state, TokenList* postfix, size_t* max_depth, ShuntError* error
+) {
+    if (!postfix) {
+        if (error) {
+            *error = state->error;
+        }
+        shunt_tree_clear(state->tree);
+        shunt_abort(state);
+        return NULL;
+    }
+
+    if (max_depth) {
+        *max_depth = state->peak;
+    }
+    return postfix;
+}
+
+/// @param tree Filled alongside the postfix (may be NULL); requires validate.
+static TokenList* shunt(
+    const TokenList* infix,
+    Arena* arena,
+    bool validate,
+    ShuntTree* tree,
+    size_t* max_depth,
+    ShuntError* error
+) {
+    shunt_error_set(error, SHUNT_STATUS_OK, TOKEN_TYPE_NONE, 0, 0);
+    if (!infix || !infix->tokens || token_list_is_empty(infix)) {
+        shunt_error_set(error, SHUNT_STATUS_EMPTY, TOKEN_TYPE_NONE, 0, 0);
+        return NULL;
+    }
+
+    SHUNT_TRACE_BEGIN(SHUNT_TRACE_SHUNT, infix->count);
+    ShuntState state;
+    TokenList* postfix = NULL;
+    if (shunt_begin(&state, arena, infix->count, NULL) && shunt_plant(&state, tree, infix->count)) {
+        state.validate = validate;
+        size_t i = 0;
+        for (; i < infix->count; i++) {
+            // The infix list is const, but unary resolution re-tags its operators in place
+            Token* symbol = (Token*) token_list_peek_index(infix, i);
+            if (!symbol || !shunt_step(&state, symbol, i)) {
+                break;
             }
+        }
 
-            if (!token_list_push(operators, (Token*) symbol)) {
-                fprintf(stderr, "[ERROR] Failed to push token to operator stack.\n");
-                goto error;
+        if (i == infix->count) {
+            postfix = shunt_end(&state, i);
+        }
+    }
+
+    postfix = shunt_finish(&state, postfix, max_depth, error);
+    SHUNT_TRACE_END(SHUNT_TRACE_SHUNT, postfix ? postfix->count : 0);
+    return postfix;
+}
+
+TokenList* shunt_yard(const TokenList* infix) {
+    return shunt(infix, NULL, false, NULL, NULL, NULL);
+}
+
+TokenList* shunt_yard_arena(const TokenList* infix, Arena* arena) {
+    return arena ? shunt(infix, arena, false, NULL, NULL, NULL) : NULL;
+}
+
+TokenList* shunt_yard_checked(const TokenList* infix, Arena* arena, ShuntError* error) {
+    return shunt(infix, arena, false, NULL, NULL, error);
+}
+
+TokenList* shunt_yard_validated(
+    const TokenList* infix, Arena* arena, size_t* max_depth, ShuntError* error
+) {
+    return shunt(infix, arena, true, NULL, max_depth, error);
+}
+
+TokenList* shunt_yard_tree(
+    const TokenList* infix, Arena* arena, ShuntTree* tree, ShuntError* error
+) {
+    if (!tree) {
+        shunt_error_set(error, SHUNT_STATUS_EMPTY, TOKEN_TYPE_NONE, 0, 0);
+        return NULL;
+    }
+    return shunt(infix, arena, true, tree, NULL, error);
+}
+
+// --- Fused Tokenize and Shunt ---
+
+/// @brief Rejects a source longer than the byte bound, before any work is done on it.
+static bool shunt_admit(const ShuntLimits* limits, size_t length, ShuntError* error) {
+    if (limits && limits->max_bytes > 0 && length > limits->max_bytes) {
+        shunt_error_set(error, SHUNT_STATUS_LIMIT, TOKEN_TYPE_NONE, limits->max_bytes, 0);
+        return false;
+    }
+    return true;
+}
+
+/// @param limits Bounds on the input (may be NULL).
+static TokenList* shunt_fused(
+    const char* expression,
+    size_t length,
+    Arena* arena,
+    bool validate,
+    ShuntTree* tree,
+    const ShuntLimits* limits,
+    size_t* max_depth,
+    ShuntError* error
+) {
+    shunt_error_set(error, SHUNT_STATUS_OK, TOKEN_TYPE_NONE, 0, 0);
+    if (!expression) {
+        shunt_error_set(error, SHUNT_STATUS_EMPTY, TOKEN_TYPE_NONE, 0, 0);
+        return NULL;
+    }
+    if (!shunt_admit(limits, length, error)) {
+        return NULL;
+    }
+
+    SHUNT_TRACE_BEGIN(SHUNT_TRACE_SHUNT, length);
+    ShuntState state;
+    TokenList* postfix = NULL;
+    const size_t capacity = tokenizer_capacity_hint(length);
+    if (shunt_begin(&state, arena, capacity, limits) && shunt_plant(&state, tree, capacity)) {
+        state.validate = validate;
+        state.adopt = !arena; // the lexer hands over fresh heap tokens
+        Lexer lexer;
+        lexer_init(&lexer, expression, length, arena, true);
+        if (shunt_lex(&state, &lexer)) {
+            postfix = shunt_end(&state, lexer.offset);
+        }
+    }
+
+    postfix = shunt_finish(&state, postfix, max_depth, error);
+    SHUNT_TRACE_END(SHUNT_TRACE_SHUNT, postfix ? postfix->count : 0);
+    return postfix;
+}
+
+TokenList* shunt_expression(const char* expression, size_t length, Arena* arena) {
+    return shunt_fused(expression, length, arena, false, NULL, NULL, NULL, NULL);
+}
+
+TokenList* shunt_expression_checked(
+    const char* expression, size_t length, Arena* arena, ShuntError* error
+) {
+    return shunt_fused(expression, length, arena, false, NULL, NULL, NULL, error);
+}
+
+TokenList* shunt_expression_validated(
+    const char* expression, size_t length, Arena* arena, size_t* max_depth, ShuntError* error
+) {
+    return shunt_fused(expression, length, arena, true, NULL, NULL, max_depth, error);
+}
+
+TokenList* shunt_expression_tree(
+    const char* expression, size_t length, Arena* arena, ShuntTree* tree, ShuntError* error
+) {
+    if (!tree) {
+        shunt_error_set(error, SHUNT_STATUS_EMPTY, TOKEN_TYPE_NONE, 0, 0);
+        return NULL;
+    }
+    return shunt_fused(expression, length, arena, true, tree, NULL, NULL, error);
+}
+
+TokenList* shunt_expression_bounded(
+    const char* expression,
+    size_t length,
+    Arena* arena,
+    const ShuntLimits* limits,
+    ShuntError* error
+) {
+    return shunt_fused(expression, length, arena, true, NULL, limits, NULL, error);
+}
+
+// --- Reusable Context ---
+
+ShuntContext* shunt_context_create(void) {
+    ShuntContext* context = malloc(sizeof(ShuntContext));
+    if (!context) {
+        return NULL;
+    }
+
+    context->error = (ShuntError) {.code = SHUNT_STATUS_OK};
+    context->validate = false;
+    context->depth = 0;
+    context->limits = (ShuntLimits) {0};
+    context->arena = arena_create(0);
+    context->postfix = context->arena ? token_list_create_arena(context->arena) : NULL;
+    context->operators = context->arena ? token_list_create_arena(context->arena) : NULL;
+    if (!context->postfix || !context->operators) {
+        shunt_context_free(context);
+        return NULL;
+    }
+
+    return context;
+}
+
+void shunt_context_reset(ShuntContext* context) {
+    if (!context) {
+        return;
+    }
+
+    token_list_clear(context->postfix);
+    token_list_clear(context->operators);
+    arena_reset(context->arena);
+}
+
+void shunt_context_free(ShuntContext* context) {
+    if (context) {
+        token_list_free(context->postfix);
+        token_list_free(context->operators);
+        arena_free(context->arena);
+        free(context);
+    }
+}
+
+/// @brief Parses into the context lists without touching tokens already held by the arena.
+static const TokenList* shunt_context_run(
+    ShuntContext* context, const char* expression, size_t length
+) {
+    token_list_clear(context->postfix);
+    token_list_clear(context->operators);
+    if (!shunt_admit(&context->limits, length, &context->error)) {
+        context->depth = 0;
+        return NULL;
+    }
+
+    ShuntState state = {
+        .postfix = context->postfix,
+        .operators = context->operators,
+        .previous = TOKEN_TYPE_NONE,
+        .error = {.code = SHUNT_STATUS_OK},
+        .validate = context->validate,
+        .limits = context->limits,
+    };
+
+    Lexer lexer;
+    lexer_init(&lexer, expression, length, context->arena, true);
+    const bool ok = shunt_lex(&state, &lexer) && shunt_drain(&state, lexer.offset);
+    context->error = state.error;
+    context->depth = ok ? state.peak : 0;
+    if (!ok) {
+        token_list_clear(context->postfix);
+        token_list_clear(context->operators);
+        return NULL;
+    }
+
+    return context->postfix;
+}
+
+const TokenList* shunt_context_parse(ShuntContext* context, const char* expression, size_t length) {
+    if (!context) {
+        return NULL;
+    }
+    if (!expression) {
+        shunt_error_set(&context->error, SHUNT_STATUS_EMPTY, TOKEN_TYPE_NONE, 0, 0);
+        return NULL;
+    }
+
+    shunt_context_reset(context);
+    const TokenList* postfix = shunt_context_run(context, expression, length);
+    if (!postfix) {
+        shunt_context_reset(context);
+    }
+    return postfix;
+}
+
+const TokenList* shunt_context_append(
+    ShuntContext* context, const char* expression, size_t length
+) {
+    if (!context) {
+        return NULL;
+    }
+    if (!expression) {
+        shunt_error_set(&context->error, SHUNT_STATUS_EMPTY, TOKEN_TYPE_NONE, 0, 0);
+        return NULL;
+    }
+
+    return shunt_context_run(context, expression, length);
+}
+
+// --- Packed Token Arrays ---
+
+static bool shunt_array_is_operator(TokenTag tag) {
+    return token_tag_kind(tag) == TOKEN_KIND_OPERATOR;
+}
+
+static bool shunt_array_is_operand(TokenTag tag) {
+    const TokenKind kind = token_tag_kind(tag);
+    return kind == TOKEN_KIND_LITERAL || kind == TOKEN_KIND_IDENTIFIER;
+}
+
+TokenArray* shunt_yard_array(const TokenArray* infix) {
+    return shunt_yard_array_checked(infix, NULL);
+}
+
+TokenArray* shunt_yard_array_checked(const TokenArray* infix, ShuntError* error) {
+    shunt_error_set(error, SHUNT_STATUS_OK, TOKEN_TYPE_NONE, 0, 0);
+    if (!infix || token_array_is_empty(infix)) {
+        shunt_error_set(error, SHUNT_STATUS_EMPTY, TOKEN_TYPE_NONE, 0, 0);
+        return NULL;
+    }
+
+    SHUNT_TRACE_BEGIN(SHUNT_TRACE_SHUNT, infix->count);
+    TokenArray* postfix = token_array_create(infix->source);
+    uint32_t* operators = malloc(sizeof(uint32_t) * infix->count); // Stack of infix indices
+    TokenTag* tags = malloc(sizeof(TokenTag) * infix->count); // Roles resolved for this pass
+    size_t top = 0;
+    if (!postfix || !operators || !tags || !token_array_reserve(postfix, infix->count)) {
+        shunt_error_set(error, SHUNT_STATUS_MEMORY, TOKEN_TYPE_NONE, 0, 0);
+        goto error;
+    }
+
+    for (size_t i = 0; i < infix->count; i++) {
+        TokenTag tag = infix->tags[i];
+        TokenType type = token_tag_type(tag);
+
+        if (shunt_array_is_operand(tag)) {
+            token_array_push(postfix, tag, infix->offsets[i], infix->sizes[i]);
+        } else if (shunt_array_is_operator(tag)) {
+            TokenTag prev = (i > 0) ? tags[i - 1] : 0;
+            const bool prefix = i == 0 || shunt_array_is_operator(prev)
+                                || token_tag_type(prev) == TOKEN_TYPE_LEFT_PAREN;
+            tag = token_tag_pack(
+                type, prefix && shunt_type_has_unary(type) ? TOKEN_ROLE_UNARY : TOKEN_ROLE_BINARY
+            );
+
+            const int o1 = token_tag_precedence(tag);
+            const bool left = token_tag_associate(tag) == TOKEN_ASSOCIATE_LEFT;
+            const bool pops = token_tag_role(tag) != TOKEN_ROLE_UNARY; // prefix: nothing to pop
+            while (pops && top > 0) {
+                const uint32_t j = operators[top - 1];
+                if (!shunt_array_is_operator(tags[j])) {
+                    break;
+                }
+
+                const int o2 = token_tag_precedence(tags[j]);
+                if (o2 > o1 || (o2 == o1 && left)) {
+                    token_array_push(postfix, tags[j], infix->offsets[j], infix->sizes[j]);
+                    top--;
+                } else {
+                    break;
+                }
             }
-        } else if (token_is_type_left_paren(symbol)) {
-            if (!token_list_push(operators, (Token*) symbol)) {
-                fprintf(stderr, "[ERROR] Failed to push token to operator stack.\n");
-                goto error;
+            operators[top++] = (uint32_t) i;
+        } else if (type == TOKEN_TYPE_LEFT_PAREN) {
+            operators[top++] = (uint32_t) i;
+        } else if (type == TOKEN_TYPE_RIGHT_PAREN) {
+            while (top > 0 && token_tag_type(tags[operators[top - 1]]) != TOKEN_TYPE_LEFT_PAREN) {
+                const uint32_t j = operators[--top];
+                token_array_push(postfix, tags[j], infix->offsets[j], infix->sizes[j]);
             }
-        } else if (token_is_type_right_paren(symbol)) {
-            if (!shunt_group(postfix, operators, i)) {
-                fprintf(stderr, "[ERROR] Failed to push token to operator stack.\n");
+
+            if (top == 0) {
+                // Mismatched parentheses
+                shunt_error_set(
+                    error, SHUNT_STATUS_UNBALANCED, type, infix->offsets[i], infix->sizes[i]
+                );
                 goto error;
             }
+            top--; // Discard the left parenthesis
         }
+
+        tags[i] = tag;
     }
 
-    Token* op = NULL;
-    while ((op = token_list_pop(operators))) {
-        if (!token_list_push(postfix, op)) {
-            fprintf(stderr, "[ERROR] Failed to push operator to stack.\n");
+    while (top > 0) {
+        const uint32_t j = operators[--top];
+        if (token_tag_type(tags[j]) == TOKEN_TYPE_LEFT_PAREN) {
+            // Unclosed parenthesis
+            shunt_error_set(
+                error,
+                SHUNT_STATUS_UNBALANCED,
+                TOKEN_TYPE_LEFT_PAREN,
+                infix->offsets[j],
+                infix->sizes[j]
+            );
             goto error;
         }
-        token_free(op);
+        token_array_push(postfix, tags[j], infix->offsets[j], infix->sizes[j]);
     }
 
-    token_list_free(operators);
+    free(operators);
+    free(tags);
+    SHUNT_TRACE_END(SHUNT_TRACE_SHUNT, postfix->count);
     return postfix;
 
 error:
-    token_list_free(postfix);
-    token_list_free(operators);
+    token_array_free(postfix);
+    free(operators);
+    free(tags);
+    SHUNT_TRACE_END(SHUNT_TRACE_SHUNT, 0);
     return NULL;
 }
 
+bool shunt_is_valid_postfix_array(const TokenArray* postfix) {
+    int64_t depth = 0;
+
+    for (size_t i = 0; i < postfix->count; i++) {
+        const TokenTag tag = postfix->tags[i];
+
+        if (shunt_array_is_operand(tag)) {
+            depth += 1;
+        } else if (token_tag_role(tag) == TOKEN_ROLE_UNARY) {
+            if (depth < 1) {
+                return false; // malformed
+            }
+        } else if (token_tag_role(tag) == TOKEN_ROLE_BINARY) {
+            if (depth < 2) {
+                return false; // malformed
+            }
+            depth -= 1; // two pops, one push
+        } else {
+            return false; // unknown token
+        }
+    }
+
+    return depth == 1;
+}
+
+void shunt_debug_array(const TokenArray* postfix) {
+    printf("[DEBUG] [POSTFIX] ");
+    for (size_t i = 0; i < postfix->count; i++) {
+        printf("%.*s ", (int) postfix->sizes[i], token_array_lexeme(postfix, i));
+    }
+    printf("\n");
+}
+
+// --- Utilities ---
+
 bool shunt_is_valid_infix(const TokenList* infix) {
     Token* previous = NULL;
     for (size_t i = 0; i < infix->count; ++i) {
@@ -170,14 +887,22 @@ bool shunt_is_valid_infix(const TokenList* infix) {
     return true;
 }
 
-bool shunt_is_valid_postfix(const TokenList* postfix) {
+bool shunt_postfix_depth(const TokenList* postfix, size_t* max_depth) {
+    if (!postfix || !postfix->tokens) {
+        return false;
+    }
+
     int64_t depth = 0;
+    int64_t peak = 0;
 
     for (size_t i = 0; i < postfix->count; i++) {
         const Token* token = token_list_peek_index(postfix, i);
 
-        if (token_is_number(token)) {
+        if (token_is_operand(token)) {
             depth += 1;
+            if (depth > peak) {
+                peak = depth;
+            }
         } else if (token_is_role_unary(token)) {
             if (depth < 1) {
                 return false; // malformed
@@ -193,14 +918,21 @@ bool shunt_is_valid_postfix(const TokenList* postfix) {
         }
     }
 
+    if (max_depth) {
+        *max_depth = (size_t) peak;
+    }
     return depth == 1;
 }
 
+bool shunt_is_valid_postfix(const TokenList* postfix) {
+    return shunt_postfix_depth(postfix, NULL);
+}
+
 void shunt_debug(const TokenList* postfix) {
     printf("[DEBUG] [POSTFIX] ");
     for (size_t i = 0; i < postfix->count; i++) {
         Token* t = postfix->tokens[i];
-        printf("%s ", t->lexeme);
+        printf("%.*s ", (int) t->size, t->lexeme);
     }
     printf("\n");
 }
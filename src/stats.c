@@ -0,0 +1,194 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file src/stats.c
+ * @brief Optional hot-path counters and begin/end trace hooks.
+ */
+
+#include <string.h>
+
+#include "stats.h"
+
+#if defined(SHUNT_STATS)
+    #include <stdlib.h>
+    #include <pthread.h>
+    #include <time.h>
+#endif
+
+// --- Counter Names ---
+
+const char* shunt_stat_to_string(ShuntStat stat) {
+    switch (stat) {
+        case SHUNT_STAT_TOKENS_LEXED:
+            return "TOKENS_LEXED";
+        case SHUNT_STAT_LIST_GROWS:
+            return "LIST_GROWS";
+        case SHUNT_STAT_TOKEN_CLONES:
+            return "TOKEN_CLONES";
+        case SHUNT_STAT_PRECEDENT_CALLS:
+            return "PRECEDENT_CALLS";
+        case SHUNT_STAT_PRECEDENT_POPS:
+            return "PRECEDENT_POPS";
+        case SHUNT_STAT_GROUP_CALLS:
+            return "GROUP_CALLS";
+        case SHUNT_STAT_GROUP_POPS:
+            return "GROUP_POPS";
+        case SHUNT_STAT_TOKENIZE_CALLS:
+            return "TOKENIZE_CALLS";
+        case SHUNT_STAT_TOKENIZE_NS:
+            return "TOKENIZE_NS";
+        case SHUNT_STAT_SHUNT_CALLS:
+            return "SHUNT_CALLS";
+        case SHUNT_STAT_SHUNT_NS:
+            return "SHUNT_NS";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+#if defined(SHUNT_STATS)
+
+// --- Thread Registry ---
+
+_Thread_local ShuntStatsLocal* shunt_stats_local = NULL;
+_Atomic(const ShuntTracer*) shunt_tracer = NULL;
+
+static pthread_mutex_t shunt_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t shunt_stats_once = PTHREAD_ONCE_INIT;
+static pthread_key_t shunt_stats_key;
+static bool shunt_stats_keyed = false;
+
+static ShuntStatsLocal* shunt_stats_live = NULL; // Blocks of running threads
+static uint64_t shunt_stats_retired[SHUNT_STAT_COUNT]; // Totals of exited threads
+static ShuntStatsLocal shunt_stats_overflow; // Shared by threads that failed to register
+
+/// @brief Runs at thread exit: folds the block into the retired totals and unlinks it.
+static void shunt_stats_detach(void* block) {
+    ShuntStatsLocal* local = block;
+
+    pthread_mutex_lock(&shunt_stats_lock);
+    for (size_t i = 0; i < SHUNT_STAT_COUNT; i++) {
+        shunt_stats_retired[i] += atomic_load_explicit(&local->values[i], memory_order_relaxed);
+    }
+
+    ShuntStatsLocal** link = &shunt_stats_live;
+    while (*link && *link != local) {
+        link = &(*link)->next;
+    }
+    if (*link) {
+        *link = local->next;
+    }
+    pthread_mutex_unlock(&shunt_stats_lock);
+
+    shunt_stats_local = NULL; // a later call on this thread registers afresh
+    free(local);
+}
+
+static void shunt_stats_init(void) {
+    shunt_stats_keyed = pthread_key_create(&shunt_stats_key, shunt_stats_detach) == 0;
+}
+
+ShuntStatsLocal* shunt_stats_attach(void) {
+    pthread_once(&shunt_stats_once, shunt_stats_init);
+
+    ShuntStatsLocal* local = calloc(1, sizeof(ShuntStatsLocal));
+    if (!local || !shunt_stats_keyed || pthread_setspecific(shunt_stats_key, local) != 0) {
+        free(local);
+        shunt_stats_local = &shunt_stats_overflow; // counts still land, just not per thread
+        return shunt_stats_local;
+    }
+
+    pthread_mutex_lock(&shunt_stats_lock);
+    local->next = shunt_stats_live;
+    shunt_stats_live = local;
+    pthread_mutex_unlock(&shunt_stats_lock);
+
+    shunt_stats_local = local;
+    return local;
+}
+
+uint64_t shunt_stats_clock(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+// --- Snapshots ---
+
+static void shunt_stats_sum(ShuntStats* stats, ShuntStatsLocal* local) {
+    for (size_t i = 0; i < SHUNT_STAT_COUNT; i++) {
+        stats->values[i] += atomic_load_explicit(&local->values[i], memory_order_relaxed);
+    }
+}
+
+static void shunt_stats_zero(ShuntStatsLocal* local) {
+    for (size_t i = 0; i < SHUNT_STAT_COUNT; i++) {
+        atomic_store_explicit(&local->values[i], 0, memory_order_relaxed);
+    }
+}
+
+bool shunt_stats_snapshot(ShuntStats* stats) {
+    if (!stats) {
+        return false;
+    }
+
+    pthread_mutex_lock(&shunt_stats_lock);
+    memcpy(stats->values, shunt_stats_retired, sizeof(stats->values));
+    for (ShuntStatsLocal* local = shunt_stats_live; local; local = local->next) {
+        shunt_stats_sum(stats, local);
+    }
+    shunt_stats_sum(stats, &shunt_stats_overflow);
+    pthread_mutex_unlock(&shunt_stats_lock);
+    return true;
+}
+
+bool shunt_stats_snapshot_local(ShuntStats* stats) {
+    if (!stats) {
+        return false;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    if (shunt_stats_local) {
+        shunt_stats_sum(stats, shunt_stats_local);
+    }
+    return true;
+}
+
+void shunt_stats_reset(void) {
+    pthread_mutex_lock(&shunt_stats_lock);
+    memset(shunt_stats_retired, 0, sizeof(shunt_stats_retired));
+    for (ShuntStatsLocal* local = shunt_stats_live; local; local = local->next) {
+        shunt_stats_zero(local);
+    }
+    shunt_stats_zero(&shunt_stats_overflow);
+    pthread_mutex_unlock(&shunt_stats_lock);
+}
+
+// --- Trace Hooks ---
+
+void shunt_trace_set(const ShuntTracer* tracer) {
+    atomic_store_explicit(&shunt_tracer, tracer, memory_order_release);
+}
+
+#else
+
+// --- Compiled Out ---
+
+bool shunt_stats_snapshot(ShuntStats* stats) {
+    if (stats) {
+        memset(stats, 0, sizeof(*stats));
+    }
+    return false;
+}
+
+bool shunt_stats_snapshot_local(ShuntStats* stats) {
+    return shunt_stats_snapshot(stats);
+}
+
+void shunt_stats_reset(void) {}
+
+void shunt_trace_set(const ShuntTracer* tracer) {
+    (void) tracer;
+}
+
+#endif // SHUNT_STATS
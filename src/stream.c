@@ -0,0 +1,211 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file src/stream.c
+ * @brief Streams newline-delimited expressions from a file descriptor or an in-memory region
+ *        (e.g. an mmap'd file) and converts each line to postfix.
+ * @note Lines are parsed in place: lexemes are views into the stream buffer or region, so no line
+ *       is ever copied into its own C string. A descriptor is read in large chunks; a line that
+ *       straddles a chunk boundary is carried to the front of the buffer before the next read.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "lexer/token_list.h"
+#include "parser.h"
+#include "stream.h"
+
+// --- Stream Lifecycle ---
+
+static ShuntStream* shunt_stream_create(int fd) {
+    ShuntStream* stream = calloc(1, sizeof(ShuntStream));
+    if (!stream) {
+        return NULL;
+    }
+
+    stream->fd = fd;
+    stream->context = shunt_context_create();
+    if (!stream->context) {
+        free(stream);
+        return NULL;
+    }
+    stream->context->validate = true; // one pass per line, no separate validators
+
+    return stream;
+}
+
+ShuntStream* shunt_stream_open_fd(int fd, size_t chunk_size) {
+    if (fd < 0) {
+        return NULL;
+    }
+
+    ShuntStream* stream = shunt_stream_create(fd);
+    if (!stream) {
+        return NULL;
+    }
+
+    stream->capacity = chunk_size > 0 ? chunk_size : SHUNT_STREAM_CHUNK;
+    stream->buffer = malloc(stream->capacity);
+    if (!stream->buffer) {
+        shunt_stream_free(stream);
+        return NULL;
+    }
+
+    stream->data = stream->buffer;
+    return stream;
+}
+
+ShuntStream* shunt_stream_open_memory(const char* data, size_t length) {
+    if (!data && length > 0) {
+        return NULL;
+    }
+
+    ShuntStream* stream = shunt_stream_create(-1);
+    if (!stream) {
+        return NULL;
+    }
+
+    stream->data = data;
+    stream->end = length;
+    stream->eof = true; // the whole input is already present
+    return stream;
+}
+
+void shunt_stream_free(ShuntStream* stream) {
+    if (stream) {
+        shunt_context_free(stream->context);
+        free(stream->buffer);
+        free(stream);
+    }
+}
+
+// --- Chunked Reads ---
+
+/// @brief Moves the unconsumed tail (a partial line) to the front of the buffer, grows the buffer
+///        if that tail already fills it, then reads one more chunk behind it.
+static bool shunt_stream_fill(ShuntStream* stream) {
+    size_t pending = stream->end - stream->start;
+    if (stream->start > 0) {
+        memmove(stream->buffer, stream->buffer + stream->start, pending);
+        stream->start = 0;
+        stream->end = pending;
+    }
+
+    if (stream->end == stream->capacity) {
+        size_t capacity = stream->capacity * 2;
+        char* buffer = realloc(stream->buffer, capacity);
+        if (!buffer) {
+            stream->error = true;
+            return false;
+        }
+        stream->buffer = buffer;
+        stream->capacity = capacity;
+        stream->data = buffer;
+    }
+
+    while (true) {
+        size_t space = stream->capacity - stream->end;
+        ssize_t size = read(stream->fd, stream->buffer + stream->end, space);
+        if (size > 0) {
+            stream->end += (size_t) size;
+            return true;
+        }
+        if (size == 0) {
+            stream->eof = true;
+            return true;
+        }
+        if (errno != EINTR) {
+            stream->error = true;
+            return false;
+        }
+    }
+}
+
+/// @brief Finds the next complete line, reading more input until a newline or end of input.
+static bool shunt_stream_line(ShuntStream* stream, size_t* offset, size_t* length) {
+    size_t scanned = stream->start; // bytes already searched for a newline
+
+    while (true) {
+        const char* newline = scanned < stream->end
+                                  ? memchr(stream->data + scanned, '\n', stream->end - scanned)
+                                  : NULL;
+        if (newline) {
+            *offset = stream->start;
+            *length = (size_t) (newline - stream->data) - stream->start;
+            stream->start += *length + 1;
+            return true;
+        }
+
+        if (stream->eof) {
+            if (stream->start == stream->end) {
+                return false; // end of input
+            }
+
+            // Last line without a trailing newline
+            *offset = stream->start;
+            *length = stream->end - stream->start;
+            stream->start = stream->end;
+            return true;
+        }
+
+        size_t searched = stream->end - stream->start;
+        if (!shunt_stream_fill(stream)) {
+            return false;
+        }
+        scanned = stream->start + searched; // the carried tail moved to the front
+    }
+}
+
+// --- Streaming ---
+
+/// @brief True if the line holds nothing but the whitespace the lexer skips (' ', '\t'..'\r').
+static bool shunt_stream_blank(const char* text, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] != ' ' && (text[i] < '\t' || text[i] > '\r')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool shunt_stream_next(ShuntStream* stream, ShuntStreamLine* line) {
+    if (!stream || !line) {
+        return false;
+    }
+
+    size_t offset = 0;
+    size_t length = 0;
+    do {
+        if (!shunt_stream_line(stream, &offset, &length)) {
+            return false;
+        }
+        stream->line++;
+
+        if (length > 0 && stream->data[offset + length - 1] == '\r') {
+            length--; // CRLF input
+        }
+    } while (shunt_stream_blank(stream->data + offset, length)); // no expression to convert
+
+    *line = (ShuntStreamLine) {
+        .text = stream->data + offset,
+        .length = length,
+        .number = stream->line,
+    };
+
+    const TokenList* postfix = shunt_context_parse(stream->context, line->text, line->length);
+    if (!postfix) {
+        line->error = stream->context->error;
+    } else {
+        line->postfix = postfix;
+        line->depth = stream->context->depth;
+    }
+
+    return true;
+}
+
+bool shunt_stream_failed(const ShuntStream* stream) {
+    return stream && stream->error;
+}
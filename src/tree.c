@@ -0,0 +1,155 @@
+/**
+ * Copyright © 2025 Austin Berrio
+ *
+ * @file src/tree.c
+ * @brief Flat expression tree: one contiguous node array linked by indices, not pointers.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "tree.h"
+
+// --- Tree Lifecycle ---
+
+ShuntTree* shunt_tree_create(void) {
+    return calloc(1, sizeof(ShuntTree));
+}
+
+void shunt_tree_free(ShuntTree* tree) {
+    if (tree) {
+        free(tree->nodes);
+        free(tree->pending);
+        free(tree);
+    }
+}
+
+void shunt_tree_clear(ShuntTree* tree) {
+    if (tree) {
+        tree->count = 0;
+        tree->pending_count = 0;
+    }
+}
+
+bool shunt_tree_reserve(ShuntTree* tree, size_t capacity) {
+    if (!tree || capacity >= SHUNT_NODE_NONE) {
+        return false;
+    }
+
+    if (capacity <= tree->capacity) {
+        return true;
+    }
+
+    ShuntNode* nodes = realloc(tree->nodes, sizeof(ShuntNode) * capacity);
+    if (!nodes) {
+        return false;
+    }
+    tree->nodes = nodes;
+
+    // Never more pending nodes than nodes
+    uint32_t* pending = realloc(tree->pending, sizeof(uint32_t) * capacity);
+    if (!pending) {
+        return false;
+    }
+    tree->pending = pending;
+
+    tree->capacity = capacity;
+    return true;
+}
+
+// --- Tree Building ---
+
+bool shunt_tree_append(ShuntTree* tree, const Token* token) {
+    if (!tree || !token) {
+        return false;
+    }
+
+    const size_t arity = token_is_operand(token)
+                             ? 0
+                             : token_descriptor(token->type, token->role)->arity;
+    if (tree->pending_count < arity) {
+        return false; // an operator without enough operands
+    }
+
+    if (tree->count == tree->capacity) {
+        const size_t capacity = tree->capacity ? tree->capacity * 2 : 8;
+        if (!shunt_tree_reserve(tree, capacity)) {
+            return false;
+        }
+    }
+
+    ShuntNode* node = &tree->nodes[tree->count];
+    node->token = token;
+    node->left = SHUNT_NODE_NONE;
+    node->right = SHUNT_NODE_NONE;
+    if (arity == 2) {
+        node->right = tree->pending[--tree->pending_count];
+        node->left = tree->pending[--tree->pending_count];
+    } else if (arity == 1) {
+        node->left = tree->pending[--tree->pending_count];
+    }
+
+    tree->pending[tree->pending_count++] = (uint32_t) tree->count++;
+    return true;
+}
+
+bool shunt_tree_from_postfix(ShuntTree* tree, const TokenList* postfix) {
+    shunt_tree_clear(tree);
+    if (!tree || !postfix || !shunt_tree_reserve(tree, postfix->count)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < postfix->count; i++) {
+        if (!shunt_tree_append(tree, postfix->tokens[i])) {
+            shunt_tree_clear(tree);
+            return false;
+        }
+    }
+
+    if (shunt_tree_root(tree) == SHUNT_NODE_NONE) {
+        shunt_tree_clear(tree);
+        return false;
+    }
+    return true;
+}
+
+// --- Tree Queries ---
+
+uint32_t shunt_tree_root(const ShuntTree* tree) {
+    if (!tree || tree->count == 0 || tree->pending_count != 1) {
+        return SHUNT_NODE_NONE;
+    }
+    return (uint32_t) (tree->count - 1); // the last operator applied spans the whole expression
+}
+
+size_t shunt_tree_arity(const ShuntNode* node) {
+    if (!node || node->left == SHUNT_NODE_NONE) {
+        return 0;
+    }
+    return node->right == SHUNT_NODE_NONE ? 1 : 2;
+}
+
+void shunt_tree_dump(const ShuntTree* tree) {
+    if (!tree) {
+        return;
+    }
+
+    for (size_t i = 0; i < tree->count; i++) {
+        const ShuntNode* node = &tree->nodes[i];
+        const Token* token = node->token;
+        printf(
+            "[ShuntTree] i=%zu, lexeme='%.*s', role=%s",
+            i,
+            (int) token->size,
+            token->lexeme,
+            token_role_to_string(token)
+        );
+        if (node->left != SHUNT_NODE_NONE) {
+            printf(", left=%u", node->left);
+        }
+        if (node->right != SHUNT_NODE_NONE) {
+            printf(", right=%u", node->right);
+        }
+        printf("\n");
+    }
+}